@@ -0,0 +1,350 @@
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include <benchmark/benchmark.h>
+
+#include <entis/core.h>
+
+// Components used by the benchmarks, C<I> is a different type per I.
+
+template <size_t I>
+struct C
+{
+    C(const float value)
+    : value{value}
+    {
+
+    }
+
+    float value;
+};
+
+// Populate a registry with count entities, every entity has C<0> and
+// one out of every rarity entities also has C<1>, C<2> and C<3>.
+
+static std::vector<entis::id_t> populate(entis::Registry& registry, const size_t count, const size_t rarity)
+{
+    std::vector<entis::id_t> entities{};
+    entities.reserve(count);
+
+    for(size_t i = 0; i < count; ++i)
+    {
+        const entis::id_t entity = registry.make_entity();
+
+        registry.bind<C<0>>(entity, 0.0f);
+
+        if(i % rarity == 0)
+        {
+            registry.bind<C<1>>(entity, 1.0f);
+            registry.bind<C<2>>(entity, 2.0f);
+            registry.bind<C<3>>(entity, 3.0f);
+        }
+
+        entities.push_back(entity);
+    }
+
+    return entities;
+}
+
+static void BM_CreateEntities(benchmark::State& state)
+{
+    const size_t count = static_cast<size_t>(state.range(0));
+
+    for(auto _ : state)
+    {
+        entis::Registry registry{};
+
+        for(size_t i = 0; i < count; ++i)
+            benchmark::DoNotOptimize(registry.make_entity());
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(BM_CreateEntities)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+static void BM_CreateKillEntities(benchmark::State& state)
+{
+    const size_t count = static_cast<size_t>(state.range(0));
+
+    entis::Registry registry{};
+    std::vector<entis::id_t> entities(count);
+
+    for(auto _ : state)
+    {
+        for(size_t i = 0; i < count; ++i)
+            entities[i] = registry.make_entity();
+
+        for(const entis::id_t entity : entities)
+            registry.kill_entity(entity);
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(BM_CreateKillEntities)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+template <size_t... I>
+static void bind_all(entis::Registry& registry, const entis::id_t entity, std::index_sequence<I...>)
+{
+    (registry.bind<C<I>>(entity, static_cast<float>(I)), ...);
+}
+
+template <size_t N>
+static void BM_Bind(benchmark::State& state)
+{
+    const size_t count = static_cast<size_t>(state.range(0));
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+
+        entis::Registry registry{};
+        std::vector<entis::id_t> entities(count);
+
+        for(size_t i = 0; i < count; ++i)
+            entities[i] = registry.make_entity();
+
+        state.ResumeTiming();
+
+        for(const entis::id_t entity : entities)
+            bind_all(registry, entity, std::make_index_sequence<N>{});
+    }
+
+    state.SetItemsProcessed(state.iterations() * count * N);
+}
+
+BENCHMARK_TEMPLATE(BM_Bind, 1)->Arg(1 << 18)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Bind, 2)->Arg(1 << 18)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Bind, 4)->Arg(1 << 18)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Bind, 8)->Arg(1 << 18)->Unit(benchmark::kMillisecond);
+
+// Kill entities with 3 components on a registry that manages 64 component types.
+
+static void BM_DestroyManyTypes(benchmark::State& state)
+{
+    const size_t count = static_cast<size_t>(state.range(0));
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+
+        entis::Registry registry{};
+        std::vector<entis::id_t> entities(count);
+
+        registry.create(count, entities.begin());
+
+        bind_all(registry, registry.make_entity(), std::make_index_sequence<64>{});
+
+        for(const entis::id_t entity : entities)
+            bind_all(registry, entity, std::make_index_sequence<3>{});
+
+        state.ResumeTiming();
+
+        registry.destroy(entities.begin(), entities.end());
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(BM_DestroyManyTypes)->Arg(1 << 16)->Unit(benchmark::kMillisecond);
+
+static void BM_GetComponentRandom(benchmark::State& state)
+{
+    const size_t count = static_cast<size_t>(state.range(0));
+
+    entis::Registry registry{};
+    std::vector<entis::id_t> entities = populate(registry, count, 1);
+
+    std::shuffle(entities.begin(), entities.end(), std::mt19937{42});
+
+    for(auto _ : state)
+    {
+        float sum = 0.0f;
+
+        for(const entis::id_t entity : entities)
+            sum += registry.get_component<C<1>>(entity).value().get().value;
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(BM_GetComponentRandom)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+static void BM_GetManyRandom(benchmark::State& state)
+{
+    const size_t count = static_cast<size_t>(state.range(0));
+
+    entis::Registry registry{};
+    std::vector<entis::id_t> entities = populate(registry, count, 1);
+    std::vector<const C<1>*> components(count);
+
+    std::shuffle(entities.begin(), entities.end(), std::mt19937{42});
+
+    const entis::Registry& reader = registry;
+
+    for(auto _ : state)
+    {
+        float sum = 0.0f;
+
+        reader.get_many<C<1>>(entities.begin(), entities.end(), components.begin());
+
+        for(const C<1>* component : components)
+            sum += component->value;
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(BM_GetManyRandom)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+template <typename With, typename Without>
+static void BM_Query(benchmark::State& state)
+{
+    const size_t count = static_cast<size_t>(state.range(0));
+    const size_t rarity = static_cast<size_t>(state.range(1));
+
+    entis::Registry registry{};
+    const std::vector<entis::id_t> entities = populate(registry, count, rarity);
+
+    // a few entities are filtered out by the Without components.
+    for(size_t i = 0; i < count; i += rarity * 2)
+        registry.bind<C<7>>(entities[i], 7.0f);
+
+    for(auto _ : state)
+        benchmark::DoNotOptimize(registry.query<With, Without>());
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+using entis::typing::type_list_t;
+
+BENCHMARK_TEMPLATE(BM_Query, type_list_t<C<0>>, type_list_t<>)->Args({1 << 20, 1})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Query, type_list_t<C<0>, C<1>>, type_list_t<>)->Args({1 << 20, 256})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Query, type_list_t<C<0>, C<1>, C<2>>, type_list_t<>)->Args({1 << 20, 256})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Query, type_list_t<C<0>, C<1>, C<2>, C<3>>, type_list_t<>)->Args({1 << 20, 256})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Query, type_list_t<C<0>, C<1>>, type_list_t<C<7>>)->Args({1 << 20, 256})->Unit(benchmark::kMillisecond);
+
+static void BM_ViewIterate(benchmark::State& state)
+{
+    const size_t count = static_cast<size_t>(state.range(0));
+
+    entis::Registry registry{};
+    populate(registry, count, 2);
+
+    for(auto _ : state)
+    {
+        registry.view<C<0>, C<1>>(entis::exclude<C<7>>).each([](C<0>& a, const C<1>& b)
+        {
+            a.value += b.value;
+        });
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(BM_ViewIterate)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+// Iterating over a cached query visits its stored matches without testing
+// any entity.
+
+static void BM_CachedQueryIterate(benchmark::State& state)
+{
+    const size_t count = static_cast<size_t>(state.range(0));
+
+    entis::Registry registry{};
+    populate(registry, count, 256);
+
+    auto& query = registry.cached_query<C<0>, C<1>>(entis::exclude<C<7>>);
+
+    for(auto _ : state)
+    {
+        query.each([](C<0>& a, const C<1>& b)
+        {
+            a.value += b.value;
+        });
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(BM_CachedQueryIterate)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+// Loading a snapshot copies the packed blocks of trivially copyable
+// components at once instead of binding entity by entity.
+
+static void BM_SnapshotLoad(benchmark::State& state)
+{
+    const size_t count = static_cast<size_t>(state.range(0));
+
+    entis::Registry registry{};
+    populate(registry, count, 4);
+
+    std::vector<std::byte> buffer{};
+    entis::OutputArchive output{buffer};
+
+    entis::Snapshot{registry}.entities(output).component<C<0>>(output).component<C<1>>(output);
+
+    for(auto _ : state)
+    {
+        entis::Registry target{};
+        entis::InputArchive input{buffer.data(), buffer.size()};
+        entis::SnapshotLoader loader{target};
+
+        loader.entities(input);
+        loader.component<C<0>>(input);
+        loader.component<C<1>>(input);
+
+        benchmark::DoNotOptimize(target);
+    }
+
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(buffer.size()));
+}
+
+BENCHMARK(BM_SnapshotLoad)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+// Every iteration kills and respawns a tenth of the entities (fragmenting
+// the packed arrays and the free list) and then iterates over them.
+
+static void BM_Churn(benchmark::State& state)
+{
+    const size_t count = static_cast<size_t>(state.range(0));
+
+    entis::Registry registry{};
+    std::vector<entis::id_t> entities = populate(registry, count, 4);
+
+    std::mt19937 generator{42};
+    std::uniform_int_distribution<size_t> pick{0, count - 1};
+
+    for(auto _ : state)
+    {
+        for(size_t i = 0; i < count / 10; ++i)
+        {
+            const size_t index = pick(generator);
+
+            registry.kill_entity(entities[index]);
+
+            entities[index] = registry.make_entity();
+
+            registry.bind<C<0>>(entities[index], 0.0f);
+
+            if(index % 4 == 0)
+                registry.bind<C<1>>(entities[index], 1.0f);
+        }
+
+        registry.view<C<0>, C<1>>().each([](C<0>& a, const C<1>& b)
+        {
+            a.value += b.value;
+        });
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(BM_Churn)->Arg(1 << 18)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,341 @@
+#ifndef BASIC_SPARSE_SET_H
+#define BASIC_SPARSE_SET_H
+
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <memory_resource>
+
+#include "stats.h"
+#include "config.h"
+#include "entity.h"
+#include "component_manager.h"
+
+namespace entis
+{
+    /**
+     * The keys of a sparse set: a paged sparse array that maps the index
+     * of a key (to_index) to its position on a packed array of keys. The
+     * containers that store the components (SparseSet, SoASet, etc.) keep
+     * their values on the same positions as the packed keys.
+     * 
+     * The packed array stores the whole key so two versions of the same
+     * index are told apart.
+     * 
+     * Every array (and the pages of the sparse array) is allocated from the
+     * memory resource the set was created with.
+     */
+    class BasicSparseSet : public IComponentManager
+    {
+    public:
+
+        /**
+         * Create an empty set of keys.
+         * 
+         * @param resource the memory resource the arrays are allocated from, it
+         * must outlive the set.
+         */
+        explicit BasicSparseSet(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : sparse_{resource},
+          dense_{resource}
+        {
+
+        }
+
+        BasicSparseSet(const BasicSparseSet&) = delete;
+
+        BasicSparseSet& operator=(const BasicSparseSet&) = delete;
+
+        /**
+         * Release the pages of the sparse array.
+         */
+        virtual ~BasicSparseSet()
+        {
+            std::pmr::memory_resource* resource = this->resource();
+
+            for(id_t* page : sparse_)
+            {
+                if(page)
+                    resource->deallocate(page, SPARSE_PAGE_SIZE * sizeof(id_t), alignof(id_t));
+            }
+        }
+
+        /**
+         * Get the memory resource the set allocates from.
+         */
+        inline std::pmr::memory_resource* resource() const noexcept
+        {
+            return dense_.get_allocator().resource();
+        }
+
+        /**
+         * Check if the key has any data associated to it.
+         * 
+         * @param key the key that we want to test.
+         * 
+         * @returns true if it has any value associated to it,
+         * false otherwise.
+         */
+        inline bool has_data(const id_t key) const noexcept
+        {
+            return !is_null_key(index(key));
+        }
+
+        /**
+         * Get the packed array of keys that have a value associated 
+         * to them. The i-th key is associated to the i-th value (if the
+         * derived set stores values).
+         * 
+         * When in_place_delete is set, the holes left by unbind are 
+         * tombstones (MAX_ID) that must be skipped (has_data yields false).
+         * 
+         * @returns a const reference to the packed array of keys.
+         */
+        inline const std::pmr::vector<id_t>& keys() const noexcept
+        {
+            return dense_;
+        }
+
+        /**
+         * Get the position of a key on the packed arrays.
+         * 
+         * @param key the key whose position we want.
+         * 
+         * @returns the index of the key (and its value) on the packed 
+         * arrays or MAX_ID if the key has no data associated to it.
+         */
+        inline id_t index(const id_t key) const noexcept
+        {
+            const size_t number = page(key);
+            const id_t* entries = number < sparse_.size() ? sparse_[number] : nullptr;
+
+            if(!entries)
+                return MAX_ID;
+
+            const id_t index = entries[offset(key)];
+
+            // null keys fail the bounds check and the packed key tells apart
+            // two versions of the same index.
+            return (index < dense_.size() && dense_[index] == key) ? index : MAX_ID;
+        }
+
+        /**
+         * Hint the processor to load the entry of a key on the sparse array
+         * (e.g. a few lookups ahead of a batch of random accesses).
+         * 
+         * @param key the key whose entry will be accessed soon.
+         */
+        inline void prefetch(const id_t key) const noexcept
+        {
+            const size_t number = page(key);
+
+            if(number < sparse_.size() && sparse_[number])
+                ENTIS_PREFETCH(sparse_[number] + offset(key));
+        }
+
+        /**
+         * Get the memory and occupancy of the arrays of the set. Derived sets
+         * add the arrays of their values.
+         * 
+         * @returns the statistics of the set (its type is left as MAX_ID).
+         */
+        virtual PoolStats stats() const noexcept
+        {
+            PoolStats stats{MAX_ID, dense_.size(), dense_.capacity(), 0, 0};
+
+            for(const id_t* page : sparse_)
+            {
+                if(page)
+                    ++stats.sparse_pages;
+            }
+
+            stats.bytes = stats.sparse_pages * SPARSE_PAGE_SIZE * sizeof(id_t) + 
+                          sparse_.capacity() * sizeof(id_t*) + dense_.capacity() * sizeof(id_t);
+
+            return stats;
+        }
+
+        /**
+         * Give the value of a key to another key, the value keeps its position
+         * on the packed arrays (see Registry::compact).
+         * 
+         * @param from a key that has data associated to it.
+         * @param to a key that has no data associated to it (nor any other
+         * key with the same index).
+         */
+        void relabel(const id_t from, const id_t to)
+        {
+            const id_t position = sparse_ref(from);
+
+            sparse_ref(from) = MAX_ID;
+
+            if(out_of_bounds(to))
+                allocate_page(to);
+
+            sparse_ref(to) = position;
+            dense_[position] = to;
+        }
+
+        /**
+         * Release the pages of the sparse array that hold no keys and the
+         * excess capacity of the packed arrays. Derived sets also release the
+         * excess capacity of their values.
+         */
+        virtual void shrink_to_fit()
+        {
+            std::pmr::memory_resource* resource = this->resource();
+            std::vector<bool> used(sparse_.size(), false);
+
+            for(const id_t key : dense_)
+            {
+                if(!is_null_key(key))
+                    used[page(key)] = true;
+            }
+
+            for(size_t i = 0; i < sparse_.size(); ++i)
+            {
+                if(sparse_[i] && !used[i])
+                {
+                    resource->deallocate(sparse_[i], SPARSE_PAGE_SIZE * sizeof(id_t), alignof(id_t));
+                    sparse_[i] = nullptr;
+                }
+            }
+
+            while(!sparse_.empty() && !sparse_.back())
+                sparse_.pop_back();
+
+            sparse_.shrink_to_fit();
+            dense_.shrink_to_fit();
+        }
+
+    protected:
+
+        // the sparse array is split in pages of SPARSE_PAGE_SIZE keys that are 
+        // allocated on demand thus, its memory depends on the keys in use instead
+        // of on the highest key, and growing it never copies the existing pages.
+        std::pmr::vector<id_t*> sparse_;
+        std::pmr::vector<id_t> dense_;
+
+        /**
+         * Get the page of the sparse array that holds the specified key.
+         * 
+         * @param key the key whose page we want.
+         * 
+         * @returns the index of the page on the page table.
+         */
+        static constexpr size_t page(const id_t key) noexcept
+        {
+            return to_index(key) / SPARSE_PAGE_SIZE;
+        }
+
+        /**
+         * Get the position of the specified key inside of its page.
+         * 
+         * @param key the key whose position we want.
+         * 
+         * @returns the offset of the key on its page.
+         */
+        static constexpr size_t offset(const id_t key) noexcept
+        {
+            return to_index(key) & (SPARSE_PAGE_SIZE - 1);
+        }
+
+        /**
+         * Check if the sparse array has a page allocated 
+         * to hold the specified key.
+         * 
+         * @param the key that we want to test.
+         * 
+         * @returns true if the page of the key hasn't been allocated,
+         * false otherwise.
+         */
+        inline bool out_of_bounds(const id_t key) const noexcept
+        {
+            const size_t index = page(key);
+
+            return index >= sparse_.size() || !sparse_[index];
+        }
+
+        /**
+         * Check if the key is not the null key
+         * 
+         * @param the key we want to test.
+         * 
+         * @returns true if the key is the MAX_ID and false
+         * otherwise.
+         */
+        inline bool is_null_key(const id_t key) const noexcept
+        {
+            return key == MAX_ID;
+        }
+
+        /**
+         * Get the position of the value of a key on the packed arrays.
+         * 
+         * @param key the key whose position we want.
+         * 
+         * @returns the index of the value on the packed arrays or MAX_ID 
+         * if the key has no data associated to it.
+         */
+        inline id_t sparse_index(const id_t key) const noexcept
+        {
+            return out_of_bounds(key) ? MAX_ID : sparse_[page(key)][offset(key)];
+        }
+
+        /**
+         * Get the entry of the sparse array for the specified key without
+         * checking if its page has been allocated.
+         * 
+         * @param key a key whose page is allocated.
+         * 
+         * @returns a reference to the entry of the key on the sparse array.
+         */
+        inline id_t& sparse_ref(const id_t key) noexcept
+        {
+            return sparse_[page(key)][offset(key)];
+        }
+
+        /**
+         * Get the entry of the sparse array for the specified key without
+         * checking if its page has been allocated.
+         * 
+         * @param key a key whose page is allocated.
+         * 
+         * @returns the entry of the key on the sparse array.
+         */
+        inline id_t sparse_ref(const id_t key) const noexcept
+        {
+            return sparse_[page(key)][offset(key)];
+        }
+
+        /**
+         * Allocate the page of the sparse array that holds the specified
+         * key, the new page is filled with null keys (MAX_ID).
+         * 
+         * @param key the key that we want the sparse set to be
+         * able to store.
+         * 
+         * @returns how much new space was allocated (number
+         * of items).
+         * 
+         * @throws an exception whenever the page can't be allocated.
+         */
+        size_t allocate_page(const id_t key)
+        {
+            const size_t index = page(key);
+
+            // only the page table (pointers) is resized.
+            if(index >= sparse_.size())
+                sparse_.resize(index + 1);
+
+            sparse_[index] = static_cast<id_t*>(resource()->allocate(SPARSE_PAGE_SIZE * sizeof(id_t), alignof(id_t)));
+
+            std::fill_n(sparse_[index], SPARSE_PAGE_SIZE, MAX_ID);
+
+            return SPARSE_PAGE_SIZE;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,225 @@
+#ifndef CACHED_QUERY_H
+#define CACHED_QUERY_H
+
+#include <tuple>
+#include <vector>
+#include <cstddef>
+
+#include "view.h"
+#include "types.h"
+#include "config.h"
+#include "tag_set.h"
+#include "signature.h"
+#include "type_list.h"
+
+namespace entis
+{
+    /**
+     * Interface used by the Registry to keep its cached queries up to date.
+     */
+    struct ICachedQuery
+    {
+        virtual ~ICachedQuery() = default;
+
+        /**
+         * Check again if an alive entity satisfies the query after one of
+         * its components was bound or unbound.
+         *
+         * @param entity the entity whose components changed.
+         */
+        virtual void refresh(const id_t entity) = 0;
+
+        /**
+         * Remove an entity from the query (e.g. when it is killed).
+         *
+         * @param entity the entity to remove.
+         */
+        virtual void remove(const id_t entity) = 0;
+
+        /**
+         * Replace an entity by its new identifier (see Registry::compact).
+         *
+         * @param from the old identifier of the entity.
+         * @param to the new identifier of the entity.
+         */
+        virtual void relabel(const id_t from, const id_t to) = 0;
+    };
+
+    /**
+     * A query whose matching entities are stored and kept up to date by
+     * the Registry (see Registry::cached_query) instead of being searched
+     * for every time, iterating over it only visits the entities that
+     * satisfy the query.
+     *
+     * Every bind, unbind and kill_entity of a component on With or Without
+     * tests the affected entity once (with its signature), thus a cached
+     * query pays off for queries that run often (e.g. every frame) while
+     * their result changes little.
+     *
+     * The entities are kept in the order they started to satisfy the query.
+     *
+     * @tparam With a type_list_t declaration of the components the entities
+     * must have.
+     * @tparam Without a type_list_t declaration of the components the entities
+     * mustn't have.
+     */
+    template <typename With, typename Without>
+    class CachedQuery;
+
+    /**
+     * Specialization used to convert the type_list_t declarations into
+     * parameter packs.
+     *
+     * @tparam With parameter pack with the components the entities must have.
+     * @tparam Without parameter pack with the components the entities mustn't have.
+     */
+    template <typename... With, typename... Without>
+    class CachedQuery<typing::type_list_t<With...>, typing::type_list_t<Without...>> : public ICachedQuery
+    {
+    public:
+
+        using ViewType = View<typing::type_list_t<With...>, typing::type_list_t<Without...>>;
+
+        /**
+         * Create a query over the specified managers and find the entities
+         * that satisfy it.
+         *
+         * @param view a view over the managers of the query (every With and
+         * Without manager must exist), it must remain valid for the lifetime
+         * of the query.
+         * @param signatures the signatures of the entities indexed by to_index
+         * (a nullptr means that the managers are probed instead).
+         * @param resource the memory resource the matches are allocated from.
+         */
+        CachedQuery(const ViewType view, const std::pmr::vector<Signature>* signatures,
+                    std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : view_{view},
+          signatures_{signatures},
+          with_mask_{signatures ? Signature::of<With...>() : Signature{}},
+          without_mask_{signatures ? Signature::of<Without...>() : Signature{}},
+          matches_{resource}
+        {
+            for(const auto& entry : view_)
+                matches_.bind(std::get<0>(entry));
+        }
+
+        /**
+         * Get the entities that satisfy the query.
+         */
+        inline const std::pmr::vector<id_t>& entities() const noexcept
+        {
+            return matches_.keys();
+        }
+
+        inline std::pmr::vector<id_t>::const_iterator begin() const noexcept
+        {
+            return matches_.keys().begin();
+        }
+
+        inline std::pmr::vector<id_t>::const_iterator end() const noexcept
+        {
+            return matches_.keys().end();
+        }
+
+        /**
+         * Get the number of entities that satisfy the query.
+         */
+        inline size_t size() const noexcept
+        {
+            return matches_.size();
+        }
+
+        /**
+         * Check if an entity satisfies the query.
+         *
+         * @param entity the entity we want to test.
+         */
+        inline bool contains(const id_t entity) const noexcept
+        {
+            return matches_.has_data(entity);
+        }
+
+        /**
+         * Get the components of an entity that satisfies the query.
+         *
+         * @param entity an entity of the query (e.g. contains(entity) yields true).
+         *
+         * @returns a tuple with the entity and references to its components
+         * (tags excluded).
+         */
+        inline typename ViewType::Entry get(const id_t entity) const noexcept
+        {
+            return view_.get(entity);
+        }
+
+        /**
+         * Apply a function to all the entities that satisfy the query.
+         *
+         * The structure of the registry mustn't change during the iteration
+         * (record the changes on a CommandBuffer instead).
+         *
+         * @tparam Fn a callable with the signature fn(id_t, With&...) or
+         * fn(With&...) (without the tags).
+         *
+         * @param fn the function to apply.
+         */
+        template <typename Fn>
+        void each(Fn&& fn) const
+        {
+            for(const id_t entity : matches_.keys())
+            {
+                if constexpr(detail::is_applicable<Fn&, typename ViewType::Entry>::value)
+                    std::apply(fn, view_.get(entity));
+                else
+                    std::apply(fn, view_.components(entity));
+            }
+        }
+
+        virtual void refresh(const id_t entity) override
+        {
+            if(matches(entity))
+                matches_.bind(entity);
+            else
+                matches_.erase(entity);
+        }
+
+        virtual void remove(const id_t entity) override
+        {
+            matches_.erase(entity);
+        }
+
+        virtual void relabel(const id_t from, const id_t to) override
+        {
+            if(matches_.has_data(from))
+                matches_.relabel(from, to);
+        }
+
+    private:
+
+        /**
+         * Marks the entities that satisfy the query.
+         */
+        struct Match
+        {
+        };
+
+        ViewType view_;
+        const std::pmr::vector<Signature>* signatures_;
+        Signature with_mask_;
+        Signature without_mask_;
+        TagSet<Match> matches_;
+
+        /**
+         * Check if an alive entity satisfies the query.
+         */
+        inline bool matches(const id_t entity) const noexcept
+        {
+            if(!signatures_)
+                return view_.contains(entity);
+
+            return (*signatures_)[to_index(entity)].matches(with_mask_, without_mask_);
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,327 @@
+#ifndef COMMAND_BUFFER_H
+#define COMMAND_BUFFER_H
+
+#include <memory>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <type_traits>
+
+#include "stats.h"
+#include "config.h"
+#include "registry.h"
+#include "type_index.h"
+
+namespace entis
+{
+    /**
+     * Records structural changes (make_entity, kill_entity, bind and unbind)
+     * so they can be applied later on with Registry::flush.
+     *
+     * Changing the structure of a registry while iterating over it (or from
+     * several threads at the same time) isn't safe since the packed arrays
+     * of the managers are rearranged. Instead, every thread can record its
+     * changes on its own buffer and flush them once the iteration finished.
+     * A single buffer must not be used by two threads at the same time.
+     *
+     * The commands are applied in batches, not in the order they were
+     * recorded: first the entities are created, then the bind/unbind
+     * commands of each component type (in increasing TypeIndex order and in
+     * the order they were recorded) so each manager is touched once and,
+     * finally, the entities are killed. Because of this, an entity created
+     * after recording the killing of another one never recycles its index
+     * and components bound to an entity that is killed by the same buffer
+     * are destroyed with it.
+     *
+     * Instead of a single type-erased arena, the commands of each component
+     * type are kept on their own packed arrays: a stream of small opcodes
+     * (entity and kind) and the values to bind, stored contiguously as T
+     * (unbinds take no space for values). Applying a type walks both arrays
+     * once and moves the values into the registry, there is no per command
+     * allocation nor indirection.
+     */
+    class CommandBuffer
+    {
+    public:
+
+        /**
+         * Handle to an entity created by the buffer, it becomes a real
+         * entity when the buffer is flushed.
+         */
+        struct Spawned
+        {
+            size_t index;
+        };
+
+        /**
+         * Create an empty command buffer.
+         */
+        CommandBuffer()
+        : spawned_{0},
+          kills_{},
+          spawned_kills_{},
+          pools_{}
+        {
+
+        }
+
+        /**
+         * Record the creation of a new entity.
+         *
+         * @returns a handle that can be used to bind components to the
+         * entity before it is created.
+         */
+        inline Spawned make_entity()
+        {
+            return Spawned{spawned_++};
+        }
+
+        /**
+         * Record the binding of a component T to an entity.
+         *
+         * @tparam T the type of the component we want to bind.
+         * @tparam ...Args a packed list of values that will be
+         * perfectly-forwarded to the constructor of T.
+         *
+         * @param entity the entity we want to associate to the T component.
+         */
+        template <typename T, typename... Args>
+        void bind(const id_t entity, Args&&... args)
+        {
+            pool<T>().push_bind(entity, false, std::forward<Args>(args)...);
+        }
+
+        /**
+         * Record the binding of a component T to an entity created by the buffer.
+         *
+         * @tparam T the type of the component we want to bind.
+         * @tparam ...Args a packed list of values that will be
+         * perfectly-forwarded to the constructor of T.
+         *
+         * @param entity the handle of the entity we want to associate to the T component.
+         */
+        template <typename T, typename... Args>
+        void bind(const Spawned entity, Args&&... args)
+        {
+            pool<T>().push_bind(static_cast<id_t>(entity.index), true, std::forward<Args>(args)...);
+        }
+
+        /**
+         * Record the deletion of the association between an entity and
+         * its component T.
+         *
+         * @tparam T the type of the component whose association we want to delete.
+         *
+         * @param entity the entity whose association we want to delete.
+         */
+        template <typename T>
+        void unbind(const id_t entity)
+        {
+            pool<T>().commands.push_back({entity, Opcode::UNBIND});
+        }
+
+        /**
+         * Record the killing of an entity.
+         *
+         * @param entity the entity to kill.
+         */
+        inline void kill_entity(const id_t entity)
+        {
+            kills_.push_back(entity);
+        }
+
+        /**
+         * Record the killing of an entity created by the buffer.
+         *
+         * @param entity the handle of the entity to kill.
+         */
+        inline void kill_entity(const Spawned entity)
+        {
+            spawned_kills_.push_back(entity.index);
+        }
+
+        /**
+         * Check if the buffer has no commands.
+         */
+        bool empty() const noexcept
+        {
+            if(spawned_ || !kills_.empty() || !spawned_kills_.empty())
+                return false;
+
+            for(const std::unique_ptr<ICommandPool>& pool : pools_)
+            {
+                if(pool && !pool->empty())
+                    return false;
+            }
+
+            return true;
+        }
+
+        /**
+         * Discard all the recorded commands (the memory is kept for reuse).
+         */
+        void clear() noexcept
+        {
+            spawned_ = 0;
+            kills_.clear();
+            spawned_kills_.clear();
+
+            for(std::unique_ptr<ICommandPool>& pool : pools_)
+            {
+                if(pool)
+                    pool->clear();
+            }
+        }
+
+        /**
+         * Apply all the recorded commands to a registry and clear the buffer.
+         *
+         * @param registry the registry that will be modified.
+         */
+        void apply(Registry& registry)
+        {
+            ENTIS_PROFILE_SCOPE("entis::CommandBuffer::apply");
+
+            std::vector<id_t> spawned{};
+
+            spawned.reserve(spawned_);
+
+            for(size_t i = 0; i < spawned_; ++i)
+                spawned.push_back(registry.make_entity());
+
+            for(std::unique_ptr<ICommandPool>& pool : pools_)
+            {
+                if(pool)
+                    pool->apply(registry, spawned);
+            }
+
+            for(const id_t entity : kills_)
+                registry.kill_entity(entity);
+
+            for(const size_t index : spawned_kills_)
+                registry.kill_entity(spawned[index]);
+
+            clear();
+        }
+
+    private:
+
+        /**
+         * Interface of the type-erased lists of commands of a component type.
+         */
+        struct ICommandPool
+        {
+            virtual ~ICommandPool() = default;
+
+            virtual void apply(Registry& registry, const std::vector<id_t>& spawned) = 0;
+
+            virtual void clear() noexcept = 0;
+
+            virtual bool empty() const noexcept = 0;
+        };
+
+        /**
+         * The kind of a bind/unbind command.
+         */
+        enum class Opcode : uint8_t
+        {
+            BIND,         // bind the next value to an entity.
+            BIND_SPAWNED, // bind the next value to a spawned entity.
+            UNBIND        // erase the component of an entity.
+        };
+
+        /**
+         * The list of bind/unbind commands of a component T.
+         *
+         * @tparam T the type of the component.
+         */
+        template <typename T>
+        struct CommandPool : public ICommandPool
+        {
+            struct Command
+            {
+                id_t entity; // entity or index of a spawned entity.
+                Opcode op;
+            };
+
+            std::vector<Command> commands;
+            std::vector<T> values; // the components to bind, in the order they were recorded.
+
+            /**
+             * Record a bind, aggregates (types without a matching constructor)
+             * are brace-initialized like SparseSet::bind does.
+             */
+            template <typename... Args>
+            void push_bind(const id_t entity, const bool spawned, Args&&... args)
+            {
+                if constexpr(std::is_constructible_v<T, Args&&...>)
+                    values.emplace_back(std::forward<Args>(args)...);
+                else
+                    values.emplace_back(T{std::forward<Args>(args)...});
+
+                commands.push_back({entity, spawned ? Opcode::BIND_SPAWNED : Opcode::BIND});
+            }
+
+            virtual void apply(Registry& registry, const std::vector<id_t>& spawned) override
+            {
+                auto value = values.begin();
+
+                for(const Command& command : commands)
+                {
+                    switch(command.op)
+                    {
+                        case Opcode::BIND:
+                            registry.bind<T>(command.entity, std::move(*value++));
+                            break;
+                        case Opcode::BIND_SPAWNED:
+                            registry.bind<T>(spawned[command.entity], std::move(*value++));
+                            break;
+                        case Opcode::UNBIND:
+                            registry.erase<T>(command.entity);
+                            break;
+                    }
+                }
+            }
+
+            virtual void clear() noexcept override
+            {
+                commands.clear();
+                values.clear();
+            }
+
+            virtual bool empty() const noexcept override
+            {
+                return commands.empty();
+            }
+        };
+
+        size_t spawned_;                                   // number of entities to create.
+        std::vector<id_t> kills_;
+        std::vector<size_t> spawned_kills_;
+        std::vector<std::unique_ptr<ICommandPool>> pools_; // indexed by TypeIndex.
+
+        /**
+         * Get the list of commands of a component T, creating it if needed.
+         */
+        template <typename T>
+        CommandPool<T>& pool()
+        {
+            const id_t index = TypeIndex::get<T>();
+
+            if(index >= pools_.size())
+                pools_.resize(index + 1);
+
+            if(!pools_[index])
+                pools_[index] = std::make_unique<CommandPool<T>>();
+
+            return static_cast<CommandPool<T>&>(*pools_[index]);
+        }
+    };
+
+    inline void Registry::flush(CommandBuffer& buffer)
+    {
+        buffer.apply(*this);
+    }
+}
+
+#endif
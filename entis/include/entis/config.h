@@ -1,13 +1,66 @@
 #ifndef ENTIS_CONFIG_H
 #define ENTIS_CONFIG_H
 
+#include <cstddef>
 #include <cstdint>
 #include <limits>
 
+/// Hint the processor to bring the cache line of an address closer (a no-op where the builtin is missing).
+#if defined(__GNUC__) || defined(__clang__)
+    #define ENTIS_PREFETCH(address) __builtin_prefetch(address)
+#else
+    #define ENTIS_PREFETCH(address) ((void)(address))
+#endif
+
+/// Code only compiled when the instrumentation is enabled (define ENTIS_ENABLE_STATS, see stats.h).
+#ifdef ENTIS_ENABLE_STATS
+    #define ENTIS_STATS(...) __VA_ARGS__
+#else
+    #define ENTIS_STATS(...)
+#endif
+
+#define ENTIS_CONCAT_IMPL(a, b) a##b
+#define ENTIS_CONCAT(a, b) ENTIS_CONCAT_IMPL(a, b)
+
+/// Time the rest of the enclosing scope and report it to the profile hook (see stats.h), it can be
+/// defined beforehand to forward the scopes to a profiler (e.g. #define ENTIS_PROFILE_SCOPE(name) ZoneScopedN(name)).
+#ifndef ENTIS_PROFILE_SCOPE
+    #ifdef ENTIS_ENABLE_STATS
+        #define ENTIS_PROFILE_SCOPE(name) const ::entis::ScopedTimer ENTIS_CONCAT(entis_scope_, __LINE__){name}
+    #else
+        #define ENTIS_PROFILE_SCOPE(name) ((void)0)
+    #endif
+#endif
+
 namespace entis
 {
     typedef uint32_t id_t;
     const id_t MAX_ID = std::numeric_limits<id_t>::max();
+
+    /// Number of bits of an id_t that store the index of an entity, the rest of them store its version.
+    const id_t INDEX_BITS = 22;
+
+    static_assert(INDEX_BITS > 0 && INDEX_BITS < std::numeric_limits<id_t>::digits, "INDEX_BITS must leave room for the version");
+
+    /// Number of keys per page of the sparse array of a SparseSet (must be a power of two).
+    const id_t SPARSE_PAGE_SIZE = 4096;
+
+    static_assert((SPARSE_PAGE_SIZE & (SPARSE_PAGE_SIZE - 1)) == 0, "SPARSE_PAGE_SIZE must be a power of two");
+
+    /// Number of component types the per-entity signatures can represent (must be a multiple of 64).
+    const size_t MAX_COMPONENTS = 128;
+
+    static_assert(MAX_COMPONENTS > 0 && MAX_COMPONENTS % 64 == 0, "MAX_COMPONENTS must be a multiple of 64");
+
+    /// Alignment (in bytes) of the field arrays of a SoASet, enough for 512-bit SIMD loads.
+    const size_t SOA_ALIGNMENT = 64;
+
+    static_assert((SOA_ALIGNMENT & (SOA_ALIGNMENT - 1)) == 0, "SOA_ALIGNMENT must be a power of two");
+
+    /// Number of keys whose lookups are prefetched ahead by the batched accesses (get_many).
+    const size_t PREFETCH_BATCH = 16;
+
+    static_assert(PREFETCH_BATCH > 0, "PREFETCH_BATCH can't be zero");
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -2,9 +2,27 @@
 #define ENTIS_H
 
 #include "config.h"
+#include "stats.h"
+#include "entity.h"
+#include "signature.h"
 #include "error.h"
+#include "sort.h"
+#include "storage.h"
+#include "soa.h"
+#include "tag_set.h"
+#include "signal.h"
 #include "registry.h"
+#include "sharded_registry.h"
+#include "observer.h"
+#include "view.h"
+#include "group.h"
+#include "thread_pool.h"
+#include "scheduler.h"
+#include "command_buffer.h"
+#include "snapshot.h"
+#include "delta.h"
 #include "type_list.h"
+#include "type_index.h"
 #include "types.h"
 
 #endif
\ No newline at end of file
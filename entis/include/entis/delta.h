@@ -0,0 +1,650 @@
+#ifndef DELTA_H
+#define DELTA_H
+
+#include <vector>
+#include <cstddef>
+#include <iterator>
+#include <cstdint>
+#include <utility>
+#include <optional>
+#include <type_traits>
+
+#include "error.h"
+#include "types.h"
+#include "config.h"
+#include "signal.h"
+#include "tag_set.h"
+#include "registry.h"
+#include "snapshot.h"
+
+namespace entis
+{
+    /**
+     * Records, in order, the entities created, killed and relabeled (see
+     * Registry::compact) on a registry since the last clear so a
+     * DeltaSnapshot can replay them.
+     *
+     * A tracker disconnects itself from the registry when destroyed thus,
+     * it mustn't outlive the registry.
+     */
+    class EntityTracker
+    {
+    public:
+
+        /**
+         * The kinds of events.
+         */
+        enum Kind : uint32_t
+        {
+            CREATED = 0,
+            KILLED = 1,
+            RELABELED = 2
+        };
+
+        /**
+         * A creation, a killing or a relabeling of an entity.
+         */
+        struct Event
+        {
+            id_t entity;   // the entity (its old identifier when relabeled).
+            uint32_t kind; // see Kind.
+            id_t target;   // the new identifier of a relabeled entity, MAX_ID otherwise.
+        };
+
+        /**
+         * Start tracking the entities of a registry.
+         *
+         * @param registry the registry whose entities will be tracked.
+         */
+        explicit EntityTracker(Registry& registry)
+        : registry_{registry},
+          events_{},
+          create_{},
+          kill_{},
+          relabel_{}
+        {
+            create_ = registry.on_create().connect([this](Registry&, const id_t entity)
+            {
+                events_.push_back(Event{entity, CREATED, MAX_ID});
+            });
+
+            kill_ = registry.on_kill().connect([this](Registry&, const id_t entity)
+            {
+                events_.push_back(Event{entity, KILLED, MAX_ID});
+            });
+
+            relabel_ = registry.on_relabel().connect([this](Registry&, const id_t from, const id_t to)
+            {
+                events_.push_back(Event{from, RELABELED, to});
+            });
+        }
+
+        EntityTracker(const EntityTracker&) = delete;
+
+        EntityTracker& operator=(const EntityTracker&) = delete;
+
+        /**
+         * Stop tracking the registry.
+         */
+        ~EntityTracker()
+        {
+            registry_.on_create().disconnect(create_);
+            registry_.on_kill().disconnect(kill_);
+            registry_.on_relabel().disconnect(relabel_);
+        }
+
+        /**
+         * Get the creations and killings since the last clear, in order.
+         */
+        inline const std::vector<Event>& events() const noexcept
+        {
+            return events_;
+        }
+
+        /**
+         * Forget the recorded events (usually once a delta was written).
+         */
+        inline void clear() noexcept
+        {
+            events_.clear();
+        }
+
+    private:
+
+        Registry& registry_;
+        std::vector<Event> events_;
+        Connection create_;
+        Connection kill_;
+        Connection relabel_;
+    };
+
+    /**
+     * Records the entities whose component T was created or updated and
+     * the ones whose component T was destroyed since the last clear, so a
+     * DeltaSnapshot only writes those. Each entity is recorded once and
+     * only its last change counts (e.g. an update after a destruction
+     * leaves it as changed). Entities relabeled by Registry::compact are
+     * recorded under their new identifier.
+     *
+     * A tracker disconnects itself from the registry when destroyed thus,
+     * it mustn't outlive the registry.
+     *
+     * @tparam T the type of the component to track.
+     */
+    template <typename T>
+    class ComponentTracker
+    {
+    public:
+
+        /**
+         * Start tracking the components T of a registry.
+         *
+         * @param registry the registry whose components will be tracked.
+         */
+        explicit ComponentTracker(Registry& registry)
+        : registry_{registry},
+          changed_{registry.resource()},
+          destroyed_{registry.resource()},
+          construct_{},
+          update_{},
+          destroy_{},
+          relabel_{}
+        {
+            construct_ = registry.on_construct<T>().connect([this](Registry&, const id_t entity)
+            {
+                change(entity);
+            });
+
+            update_ = registry.on_update<T>().connect([this](Registry&, const id_t entity)
+            {
+                change(entity);
+            });
+
+            destroy_ = registry.on_destroy<T>().connect([this](Registry&, const id_t entity)
+            {
+                changed_.erase(entity);
+                destroyed_.bind(entity);
+            });
+
+            relabel_ = registry.on_relabel().connect([this](Registry&, const id_t from, const id_t to)
+            {
+                // changed entities are alive so the new index is free.
+                if(changed_.has_data(from))
+                    changed_.relabel(from, to);
+
+                // a killed entity may hold the new index, binding replaces it
+                // (its components are destroyed anyway when the kill is replayed).
+                if(destroyed_.erase(from))
+                    destroyed_.bind(to);
+            });
+        }
+
+        ComponentTracker(const ComponentTracker&) = delete;
+
+        ComponentTracker& operator=(const ComponentTracker&) = delete;
+
+        /**
+         * Stop tracking the registry.
+         */
+        ~ComponentTracker()
+        {
+            registry_.on_construct<T>().disconnect(construct_);
+            registry_.on_update<T>().disconnect(update_);
+            registry_.on_destroy<T>().disconnect(destroy_);
+            registry_.on_relabel().disconnect(relabel_);
+        }
+
+        /**
+         * Get the entities whose component was created or updated.
+         */
+        inline const std::pmr::vector<id_t>& changed() const noexcept
+        {
+            return changed_.keys();
+        }
+
+        /**
+         * Get the entities whose component was destroyed.
+         */
+        inline const std::pmr::vector<id_t>& destroyed() const noexcept
+        {
+            return destroyed_.keys();
+        }
+
+        /**
+         * Forget the recorded changes (in O(number of changes)), usually
+         * once a delta was written.
+         */
+        void clear()
+        {
+            while(changed_.size() > 0)
+                changed_.erase(changed_.keys().back());
+
+            while(destroyed_.size() > 0)
+                destroyed_.erase(destroyed_.keys().back());
+        }
+
+    private:
+
+        /**
+         * Marks the tracked entities.
+         */
+        struct Touched
+        {
+        };
+
+        Registry& registry_;
+        TagSet<Touched> changed_;
+        TagSet<Touched> destroyed_;
+        Connection construct_;
+        Connection update_;
+        Connection destroy_;
+        Connection relabel_;
+
+        inline void change(const id_t entity)
+        {
+            destroyed_.erase(entity);
+            changed_.bind(entity);
+        }
+    };
+
+    namespace detail
+    {
+        /// Tag written at the beginning of the entities block of a delta ("ENTD").
+        inline constexpr uint32_t DELTA_MAGIC = 0x44544e45;
+    }
+
+    /**
+     * Writes the changes recorded by trackers since their last clear: the
+     * creations, killings and relabelings of entities (in order) and, for each type, the
+     * keys of the destroyed components followed by the keys and values of
+     * the created or updated ones.
+     *
+     * A delta applies on top of the state of a registry right when the
+     * trackers were cleared (the baseline, e.g. a full Snapshot or the
+     * previous delta) and the blocks must be loaded in the same order
+     * they were written (see DeltaLoader):
+     *
+     * entis::DeltaSnapshot{registry}.entities(archive, entities).component<Transform>(archive, transforms);
+     *
+     * entities.clear();
+     * transforms.clear();
+     */
+    class DeltaSnapshot
+    {
+    public:
+
+        /**
+         * Create a delta of a registry.
+         *
+         * @param registry the registry to write, it mustn't change meanwhile.
+         */
+        explicit DeltaSnapshot(const Registry& registry)
+        : registry_{registry}
+        {
+
+        }
+
+        /**
+         * Write the creations, killings and relabelings of entities.
+         *
+         * @param archive the archive the block is appended to.
+         * @param tracker the tracker of the entities of the registry.
+         *
+         * @returns the delta itself so calls can be chained.
+         */
+        const DeltaSnapshot& entities(OutputArchive& archive, const EntityTracker& tracker) const
+        {
+            archive.write(detail::DELTA_MAGIC);
+            archive.write(detail::SNAPSHOT_VERSION);
+            archive.write(static_cast<uint64_t>(tracker.events().size()));
+            archive.write(tracker.events().data(), tracker.events().size());
+
+            return *this;
+        }
+
+        /**
+         * Write the changes of the components T, they must be trivially
+         * copyable (see the overload with a serialization function otherwise).
+         *
+         * @tparam T the type of the components.
+         *
+         * @param archive the archive the block is appended to.
+         * @param tracker the tracker of the components T of the registry.
+         *
+         * @returns the delta itself so calls can be chained.
+         */
+        template <typename T>
+        const DeltaSnapshot& component(OutputArchive& archive, const ComponentTracker<T>& tracker) const
+        {
+            static_assert(is_tag_v<T> || std::is_trivially_copyable_v<T>,
+                          "components that aren't trivially copyable need a serialization function");
+
+            return component<T>(archive, tracker, [](OutputArchive& archive, const T& value)
+            {
+                archive.write(value);
+            });
+        }
+
+        /**
+         * Write the changes of the components T with a serialization function.
+         *
+         * @tparam T the type of the components.
+         * @tparam Fn a callable with the signature fn(OutputArchive&, const T&)
+         * (it isn't called for tags).
+         *
+         * @param archive the archive the block is appended to.
+         * @param tracker the tracker of the components T of the registry.
+         * @param fn the function that writes a single component.
+         *
+         * @returns the delta itself so calls can be chained.
+         */
+        template <typename T, typename Fn>
+        const DeltaSnapshot& component(OutputArchive& archive, const ComponentTracker<T>& tracker, Fn&& fn) const
+        {
+            const std::pmr::vector<id_t>& destroyed = tracker.destroyed();
+            const std::pmr::vector<id_t>& changed = tracker.changed();
+
+            archive.write(static_cast<uint64_t>(destroyed.size()));
+            archive.write(destroyed.data(), destroyed.size());
+            archive.write(static_cast<uint64_t>(changed.size()));
+            archive.write(changed.data(), changed.size());
+
+            if constexpr(!is_tag_v<T>)
+            {
+                // the tracker only holds entities that have the component.
+                const ComponentManager<T> manager = registry_.get_component_manager<T>();
+
+                for(const id_t entity : changed)
+                    fn(archive, manager->get(entity));
+            }
+
+            return *this;
+        }
+
+    private:
+
+        const Registry& registry_;
+    };
+
+    /**
+     * Applies the blocks written by a DeltaSnapshot to a registry whose
+     * state is the baseline of the delta, in the same order they were
+     * written. Entities are created, killed and relabeled in the recorded
+     * order so they get the same identifiers they have on the registry that
+     * wrote the delta.
+     *
+     * The changes go through the registry (insert, bind_range, erase and
+     * kill_entity) so its bookkeeping and signals are updated as usual. The
+     * components of a block are bound in bulk once every key was checked.
+     */
+    class DeltaLoader
+    {
+    public:
+
+        /**
+         * Create a loader for a registry.
+         *
+         * @param registry the registry the deltas are applied to.
+         */
+        explicit DeltaLoader(Registry& registry)
+        : registry_{registry}
+        {
+
+        }
+
+        /**
+         * Replay the creations, killings and relabelings of entities.
+         *
+         * @param archive the archive to read from.
+         *
+         * @returns an empty optional when the block was applied, a
+         * LoadError::BAD_FORMAT when the registry isn't at the baseline of
+         * the delta (e.g. a created entity got another identifier) and the
+         * corresponding LoadError otherwise.
+         */
+        std::optional<error::LoadError> entities(InputArchive& archive)
+        {
+            uint32_t magic = 0;
+            uint32_t version = 0;
+            uint64_t count = 0;
+
+            if(!archive.read(magic) || !archive.read(version))
+                return error::LoadError::TRUNCATED;
+
+            if(magic != detail::DELTA_MAGIC || version != detail::SNAPSHOT_VERSION)
+                return error::LoadError::BAD_FORMAT;
+
+            if(!archive.read(count))
+                return error::LoadError::TRUNCATED;
+
+            const EntityTracker::Event* events = archive.block<EntityTracker::Event>(static_cast<size_t>(count));
+
+            if(!events)
+                return error::LoadError::TRUNCATED;
+
+            // the list of dead entities is rebuilt after a run of relabels (see Registry::compact).
+            bool relabeled = false;
+
+            for(size_t i = 0; i < count; ++i)
+            {
+                const EntityTracker::Event& event = events[i];
+
+                if(event.kind == EntityTracker::RELABELED)
+                {
+                    if(!can_relabel(event.entity, event.target))
+                        return error::LoadError::BAD_FORMAT;
+
+                    registry_.relabel(event.entity, event.target);
+                    relabeled = true;
+
+                    continue;
+                }
+
+                if(relabeled)
+                {
+                    registry_.rebuild_free_list();
+                    relabeled = false;
+                }
+
+                if(event.kind == EntityTracker::KILLED)
+                {
+                    // a dead entity means the registry isn't at the baseline.
+                    if(!registry_.is_alive(event.entity))
+                        return error::LoadError::BAD_FORMAT;
+
+                    registry_.kill_entity(event.entity);
+                }
+                else if(event.kind != EntityTracker::CREATED || registry_.make_entity() != event.entity)
+                    return error::LoadError::BAD_FORMAT;
+            }
+
+            if(relabeled)
+                registry_.rebuild_free_list();
+
+            return std::optional<error::LoadError>{};
+        }
+
+        /**
+         * Apply the changes of the components T, they must be trivially
+         * copyable (see the overload with a deserialization function otherwise).
+         * The values are bound in bulk straight from the archive.
+         *
+         * @tparam T the type of the components.
+         *
+         * @param archive the archive to read from.
+         *
+         * @returns an empty optional when the block was applied, a
+         * LoadError::BAD_FORMAT when a changed entity is dead or repeated and
+         * the corresponding LoadError otherwise. Nothing is applied on errors.
+         */
+        template <typename T>
+        std::optional<error::LoadError> component(InputArchive& archive)
+        {
+            static_assert(is_tag_v<T> || std::is_trivially_copyable_v<T>,
+                          "components that aren't trivially copyable need a deserialization function");
+
+            Block block{};
+
+            if(const std::optional<error::LoadError> error = read_block(archive, block))
+                return error;
+
+            if constexpr(is_tag_v<T>)
+            {
+                apply<T>(block);
+            }
+            else
+            {
+                const T* values = archive.block<T>(block.changed_count);
+
+                if(!values)
+                    return error::LoadError::TRUNCATED;
+
+                apply<T>(block, values);
+            }
+
+            return std::optional<error::LoadError>{};
+        }
+
+        /**
+         * Apply the changes of the components T with a deserialization
+         * function. Every value is read before the registry is changed.
+         *
+         * @tparam T the type of the components.
+         * @tparam Fn a callable with the signature fn(InputArchive&) that
+         * returns a T (it isn't called for tags).
+         *
+         * @param archive the archive to read from.
+         * @param fn the function that reads a single component.
+         *
+         * @returns an empty optional when the block was applied, a
+         * LoadError::BAD_FORMAT when a changed entity is dead or repeated and
+         * the corresponding LoadError otherwise. Nothing is applied on errors.
+         */
+        template <typename T, typename Fn>
+        std::optional<error::LoadError> component(InputArchive& archive, Fn&& fn)
+        {
+            Block block{};
+
+            if(const std::optional<error::LoadError> error = read_block(archive, block))
+                return error;
+
+            if constexpr(is_tag_v<T>)
+            {
+                apply<T>(block);
+            }
+            else
+            {
+                std::vector<T> values{};
+
+                values.reserve(block.changed_count);
+
+                for(size_t i = 0; i < block.changed_count; ++i)
+                {
+                    values.push_back(fn(archive));
+
+                    if(archive.failed())
+                        return error::LoadError::TRUNCATED;
+                }
+
+                apply<T>(block, std::make_move_iterator(values.begin()));
+            }
+
+            return std::optional<error::LoadError>{};
+        }
+
+    private:
+
+        Registry& registry_;
+
+        /**
+         * The keys of a block of components.
+         */
+        struct Block
+        {
+            const id_t* destroyed = nullptr;
+            size_t destroyed_count = 0;
+            const id_t* changed = nullptr;
+            size_t changed_count = 0;
+        };
+
+        /**
+         * Read the keys of a block of components and check that every
+         * changed entity is alive and appears once, before anything changes.
+         */
+        std::optional<error::LoadError> read_block(InputArchive& archive, Block& block) const
+        {
+            if(!read_keys(archive, block.destroyed, block.destroyed_count) ||
+               !read_keys(archive, block.changed, block.changed_count))
+                return error::LoadError::TRUNCATED;
+
+            std::vector<bool> seen(registry_.entities_.size());
+
+            for(size_t i = 0; i < block.changed_count; ++i)
+            {
+                const id_t entity = block.changed[i];
+
+                if(!registry_.is_alive(entity) || seen[to_index(entity)])
+                    return error::LoadError::BAD_FORMAT;
+
+                seen[to_index(entity)] = true;
+            }
+
+            return std::optional<error::LoadError>{};
+        }
+
+        /**
+         * Apply a validated block of tags.
+         */
+        template <typename T>
+        void apply(const Block& block)
+        {
+            // killed entities already lost their components.
+            for(size_t i = 0; i < block.destroyed_count; ++i)
+                registry_.erase<T>(block.destroyed[i]);
+
+            registry_.bind_range<T>(block.changed, block.changed + block.changed_count);
+        }
+
+        /**
+         * Apply a validated block of components, the manager grows once.
+         */
+        template <typename T, typename ValueIt>
+        void apply(const Block& block, ValueIt values)
+        {
+            for(size_t i = 0; i < block.destroyed_count; ++i)
+                registry_.erase<T>(block.destroyed[i]);
+
+            registry_.insert<T>(block.changed, block.changed + block.changed_count, values);
+        }
+
+        /**
+         * Check that an alive entity can take the identifier of a relabel:
+         * its index is dead and it is the next version of that index.
+         */
+        bool can_relabel(const id_t from, const id_t to) const
+        {
+            const size_t index = to_index(to);
+
+            return registry_.is_alive(from) && index < registry_.entities_.size() &&
+                !registry_.is_alive_slot(index) && to_version(registry_.entities_[index]) == to_version(to);
+        }
+
+        /**
+         * Read a block of keys preceded by its size.
+         */
+        static bool read_keys(InputArchive& archive, const id_t*& keys, size_t& count)
+        {
+            uint64_t size = 0;
+
+            if(!archive.read(size))
+                return false;
+
+            count = static_cast<size_t>(size);
+            keys = archive.block<id_t>(count);
+
+            return keys != nullptr;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef ENTITY_H
+#define ENTITY_H
+
+#include "config.h"
+
+namespace entis
+{
+    /// Mask used to get the index of an entity (also the null index).
+    const id_t INDEX_MASK = (id_t{1} << INDEX_BITS) - 1;
+
+    /// Mask used to get the version of an entity once shifted.
+    const id_t VERSION_MASK = MAX_ID >> INDEX_BITS;
+
+    /// Index used to represent the end of the list of dead entities (it's never handed out).
+    const id_t NULL_INDEX = INDEX_MASK;
+
+    /**
+     * Get the index of an entity, this is, its position on the
+     * vector of entities of a registry.
+     *
+     * @param entity the entity whose index we want.
+     *
+     * @returns the lower INDEX_BITS of the entity.
+     */
+    inline constexpr id_t to_index(const id_t entity) noexcept
+    {
+        return entity & INDEX_MASK;
+    }
+
+    /**
+     * Get the version of an entity, this is, how many times its
+     * index was recycled (modulo VERSION_MASK + 1).
+     *
+     * @param entity the entity whose version we want.
+     *
+     * @returns the upper bits of the entity.
+     */
+    inline constexpr id_t to_version(const id_t entity) noexcept
+    {
+        return (entity >> INDEX_BITS) & VERSION_MASK;
+    }
+
+    /**
+     * Combine an index and a version into an entity.
+     *
+     * @param index the index of the entity.
+     * @param version the version of the entity.
+     *
+     * @returns the entity.
+     */
+    inline constexpr id_t make_id(const id_t index, const id_t version) noexcept
+    {
+        return (index & INDEX_MASK) | ((version & VERSION_MASK) << INDEX_BITS);
+    }
+}
+
+#endif
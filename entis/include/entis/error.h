@@ -26,6 +26,30 @@ namespace entis
         { BindError::INVALID_KEY, "key must be less than MAX_ID" },
         { BindError::DEAD_ENTITY, "entity must be alive" }
     };
+
+    /**
+     * Possible errors that could arise while loading
+     * a snapshot into a registry.
+     */
+    enum class LoadError
+    {
+        /// The archive ended before the block was complete.
+        TRUNCATED,
+
+        /// The archive isn't a snapshot (or was written by another version).
+        BAD_FORMAT,
+
+        /// The registry (or the manager of the component) isn't empty.
+        NOT_EMPTY
+    };
+
+    /// "Long" descriptions of the errors defined on LoadError enum.
+    const std::unordered_map<LoadError, const char*> LOAD_ERROR_DESC =
+    {
+        { LoadError::TRUNCATED, "the archive is truncated" },
+        { LoadError::BAD_FORMAT, "the archive isn't a valid snapshot" },
+        { LoadError::NOT_EMPTY, "snapshots can only be loaded into empty registries" }
+    };
     }
 }
 
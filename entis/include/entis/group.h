@@ -0,0 +1,230 @@
+#ifndef GROUP_H
+#define GROUP_H
+
+#include <tuple>
+#include <vector>
+#include <type_traits>
+
+#include "config.h"
+#include "sparse_set.h"
+#include "type_index.h"
+
+namespace entis
+{
+    /**
+     * Interface used by the Registry to keep the groups up to date
+     * whenever an owned component is bound or unbound.
+     */
+    struct IGroup
+    {
+        virtual ~IGroup() = default;
+
+        /**
+         * Move the entity into the group if it has all the owned
+         * components (called after binding an owned component).
+         *
+         * @param entity the entity whose component was bound.
+         */
+        virtual void on_bind(const id_t entity) = 0;
+
+        /**
+         * Move the entity out of the group if it belongs to it (called
+         * before unbinding an owned component).
+         *
+         * @param entity the entity whose component will be unbound.
+         */
+        virtual void on_unbind(const id_t entity) = 0;
+
+        /**
+         * Get the identifier (BasicTypeIndex<detail::GroupFamily>) of the
+         * concrete group type.
+         */
+        virtual id_t type() const noexcept = 0;
+    };
+
+    /**
+     * Keeps the entities that have all the Owned components at the front
+     * of the packed arrays of their managers, in the same order. Because
+     * of this, the i-th value of every owned manager belongs to the same
+     * entity (for i < size()) and the group can be iterated in lockstep
+     * without probing the sparse arrays.
+     *
+     * @tparam Owned the types of the components owned by the group.
+     */
+    template <typename... Owned>
+    class OwningGroup : public IGroup
+    {
+        static_assert(sizeof...(Owned) > 1, "a group must own at least two components");
+        static_assert((!SparseSet<Owned>::in_place_delete && ...), "a group can only own packed components");
+
+    public:
+
+        /**
+         * Create a group over the specified managers and arrange the
+         * entities that already have all the owned components.
+         *
+         * @param pools the managers of the owned components.
+         */
+        explicit OwningGroup(const std::tuple<SparseSet<Owned>*...> pools)
+        : pools_{pools},
+          length_{0}
+        {
+            const std::pmr::vector<id_t>& driver = smallest();
+
+            // iterate over a copy since the packed arrays are rearranged.
+            const std::vector<id_t> entities(driver.begin(), driver.end());
+
+            for(const id_t entity : entities)
+                on_bind(entity);
+        }
+
+        virtual void on_bind(const id_t entity) override
+        {
+            if((std::get<SparseSet<Owned>*>(pools_)->has_data(entity) && ...) && !contains(entity))
+            {
+                (std::get<SparseSet<Owned>*>(pools_)->swap(entity,
+                    std::get<SparseSet<Owned>*>(pools_)->keys()[length_]), ...);
+
+                ++length_;
+            }
+        }
+
+        virtual void on_unbind(const id_t entity) override
+        {
+            if(contains(entity))
+            {
+                --length_;
+
+                (std::get<SparseSet<Owned>*>(pools_)->swap(entity,
+                    std::get<SparseSet<Owned>*>(pools_)->keys()[length_]), ...);
+            }
+        }
+
+        virtual id_t type() const noexcept override
+        {
+            return BasicTypeIndex<detail::GroupFamily>::get<OwningGroup<Owned...>>();
+        }
+
+        /**
+         * Check if an entity belongs to the group.
+         *
+         * @param entity the entity we want to test.
+         *
+         * @returns true if the entity has all the owned components,
+         * false otherwise.
+         */
+        inline bool contains(const id_t entity) const noexcept
+        {
+            return std::get<0>(pools_)->index(entity) < length_;
+        }
+
+        /**
+         * Get the number of entities that belong to the group.
+         */
+        inline size_t size() const noexcept
+        {
+            return length_;
+        }
+
+        /**
+         * Get the managers of the owned components.
+         */
+        inline const std::tuple<SparseSet<Owned>*...>& pools() const noexcept
+        {
+            return pools_;
+        }
+
+    private:
+
+        std::tuple<SparseSet<Owned>*...> pools_;
+        size_t length_; // entities on [0, length_) have all the owned components.
+
+        /**
+         * Get the packed array of keys of the smallest owned manager.
+         */
+        const std::pmr::vector<id_t>& smallest() const noexcept
+        {
+            const std::pmr::vector<id_t>* driver = nullptr;
+
+            ((driver = (!driver || std::get<SparseSet<Owned>*>(pools_)->size() < driver->size())
+                ? &std::get<SparseSet<Owned>*>(pools_)->keys() : driver), ...);
+
+            return *driver;
+        }
+    };
+
+    /**
+     * A lightweight handle used to iterate over the entities of an
+     * OwningGroup, the components are visited in lockstep (a linear
+     * scan over the packed arrays of every owned manager).
+     *
+     * @tparam Owned the types of the components owned by the group.
+     */
+    template <typename... Owned>
+    class Group
+    {
+    public:
+
+        /**
+         * Create a handle to the specified group.
+         *
+         * @param group the group that will be iterated.
+         */
+        explicit Group(const OwningGroup<Owned...>& group)
+        : group_{&group}
+        {
+
+        }
+
+        /**
+         * Get the number of entities that belong to the group.
+         */
+        inline size_t size() const noexcept
+        {
+            return group_->size();
+        }
+
+        /**
+         * Check if an entity belongs to the group.
+         *
+         * @param entity the entity we want to test.
+         */
+        inline bool contains(const id_t entity) const noexcept
+        {
+            return group_->contains(entity);
+        }
+
+        /**
+         * Apply a function to all the entities of the group.
+         *
+         * @tparam Fn a callable with the signature fn(id_t, Owned&...) or
+         * fn(Owned&...).
+         *
+         * @param fn the function to apply.
+         */
+        template <typename Fn>
+        void each(Fn&& fn) const
+        {
+            const std::tuple<SparseSet<Owned>*...>& pools = group_->pools();
+
+            const id_t* entities = std::get<0>(pools)->keys().data();
+            const std::tuple<Owned*...> data{ std::get<SparseSet<Owned>*>(pools)->data()... };
+
+            const size_t length = group_->size();
+
+            for(size_t i = 0; i < length; ++i)
+            {
+                if constexpr(std::is_invocable_v<Fn, id_t, Owned&...>)
+                    fn(entities[i], std::get<Owned*>(data)[i]...);
+                else
+                    fn(std::get<Owned*>(data)[i]...);
+            }
+        }
+
+    private:
+
+        const OwningGroup<Owned...>* group_;
+    };
+}
+
+#endif
@@ -0,0 +1,158 @@
+#ifndef OBSERVER_H
+#define OBSERVER_H
+
+#include <vector>
+#include <cstddef>
+
+#include "config.h"
+#include "signal.h"
+#include "tag_set.h"
+#include "registry.h"
+
+namespace entis
+{
+    /**
+     * Collects the entities whose component T was bound or updated (patch
+     * or bind on an entity that already had one) since the last clear, so
+     * the systems that react to those changes (e.g. replication or a spatial
+     * index) process only the changed entities instead of the whole pool.
+     *
+     * Each entity is collected once regardless of the number of changes, in
+     * the order of its first change. Entities that lose their component T
+     * are dropped from the list and the ones relabeled by Registry::compact
+     * keep their place under their new identifier.
+     *
+     * An observer disconnects itself from the registry when destroyed thus,
+     * it mustn't outlive the registry.
+     *
+     * @tparam T the type of the component to observe.
+     */
+    template <typename T>
+    class Observer
+    {
+    public:
+
+        /**
+         * Start observing the components T of a registry.
+         *
+         * @param registry the registry whose components will be observed.
+         */
+        explicit Observer(Registry& registry)
+        : registry_{registry},
+          touched_{registry.resource()},
+          construct_{},
+          update_{},
+          destroy_{},
+          relabel_{}
+        {
+            construct_ = registry.on_construct<T>().connect([this](Registry&, const id_t entity)
+            {
+                touched_.bind(entity);
+            });
+
+            update_ = registry.on_update<T>().connect([this](Registry&, const id_t entity)
+            {
+                touched_.bind(entity);
+            });
+
+            destroy_ = registry.on_destroy<T>().connect([this](Registry&, const id_t entity)
+            {
+                touched_.erase(entity);
+            });
+
+            // the collected entities are alive so the new index is free.
+            relabel_ = registry.on_relabel().connect([this](Registry&, const id_t from, const id_t to)
+            {
+                if(touched_.has_data(from))
+                    touched_.relabel(from, to);
+            });
+        }
+
+        Observer(const Observer&) = delete;
+
+        Observer& operator=(const Observer&) = delete;
+
+        /**
+         * Stop observing the registry.
+         */
+        ~Observer()
+        {
+            registry_.on_construct<T>().disconnect(construct_);
+            registry_.on_update<T>().disconnect(update_);
+            registry_.on_destroy<T>().disconnect(destroy_);
+            registry_.on_relabel().disconnect(relabel_);
+        }
+
+        /**
+         * Get the entities changed since the last clear.
+         */
+        inline const std::pmr::vector<id_t>& entities() const noexcept
+        {
+            return touched_.keys();
+        }
+
+        inline std::pmr::vector<id_t>::const_iterator begin() const noexcept
+        {
+            return touched_.keys().begin();
+        }
+
+        inline std::pmr::vector<id_t>::const_iterator end() const noexcept
+        {
+            return touched_.keys().end();
+        }
+
+        /**
+         * Get the number of entities changed since the last clear.
+         */
+        inline size_t size() const noexcept
+        {
+            return touched_.size();
+        }
+
+        /**
+         * Check if no entity changed since the last clear.
+         */
+        inline bool empty() const noexcept
+        {
+            return touched_.size() == 0;
+        }
+
+        /**
+         * Check if an entity changed since the last clear.
+         *
+         * @param entity the entity we want to test.
+         */
+        inline bool contains(const id_t entity) const noexcept
+        {
+            return touched_.has_data(entity);
+        }
+
+        /**
+         * Forget the collected entities (in O(number of entities)), usually
+         * once they were processed.
+         */
+        void clear()
+        {
+            while(touched_.size() > 0)
+                touched_.erase(touched_.keys().back());
+        }
+
+    private:
+
+        /**
+         * Marks the entities that changed.
+         */
+        struct Touched
+        {
+        };
+
+        Registry& registry_;
+        TagSet<Touched> touched_;
+        Connection construct_;
+        Connection update_;
+        Connection destroy_;
+        Connection relabel_;
+    };
+}
+
+#endif
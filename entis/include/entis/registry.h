@@ -2,21 +2,35 @@
 #define REGISTRY_H
 
 #include <tuple>
+#include <chrono>
 #include <vector>
 #include <memory>
+#include <cassert>
 #include <utility>
+#include <iterator>
 #include <optional>
-#include <typeinfo>
 #include <algorithm>
-#include <unordered_map>
+#include <memory_resource>
 
+#include "view.h"
+#include "group.h"
 #include "types.h"
 #include "config.h"
+#include "entity.h"
+#include "stats.h"
+#include "signal.h"
+#include "signature.h"
 #include "type_list.h"
+#include "cached_query.h"
 #include "sparse_set.h"
+#include "type_index.h"
 
 namespace entis
 {
+    class CommandBuffer;
+    class Snapshot;
+    class SnapshotLoader;
+
     /**
      * Manages all the entities with their components by
      * providing a centralized interface for:
@@ -31,60 +45,388 @@ namespace entis
      */ 
     class Registry
     {
+        friend class Snapshot;
+        friend class SnapshotLoader;
+        friend class DeltaSnapshot;
+        friend class DeltaLoader;
 
     public:
+
+        /// Signal published with the registry and the entity whose component changed.
+        using Hook = Signal<Registry&, id_t>;
+
+        /// Signal published with the registry, the old and the new identifier of a relabeled entity.
+        using RelabelHook = Signal<Registry&, id_t, id_t>;
+
         /**
          * Create a new empty Registry.
+         * 
+         * The entities and every component manager (its sparse, packed and
+         * value arrays) are allocated from the specified memory resource, e.g.
+         * a std::pmr::monotonic_buffer_resource per match instance whose memory
+         * is released at once when the match ends:
+         * 
+         * std::pmr::monotonic_buffer_resource arena{};
+         * entis::Registry registry{&arena};
+         * 
+         * @param resource the memory resource, it must outlive the registry.
+         */
+        explicit Registry(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : current_{NULL_INDEX},
+          entities_{resource},
+          signatures_{resource},
+          component_managers_{},
+          groups_{},
+          owners_{},
+          hooks_{},
+          queries_{},
+          watchers_{},
+          create_hook_{},
+          kill_hook_{},
+          relabel_hook_{},
+          frozen_{false}
+#ifdef ENTIS_ENABLE_STATS
+          , stats_{}
+#endif
+        {
+
+        }
+
+        /**
+         * Get the memory resource the registry allocates from.
+         */
+        inline std::pmr::memory_resource* resource() const noexcept
+        {
+            return entities_.get_allocator().resource();
+        }
+
+        /**
+         * Start a read phase: until thaw is called the entities and the layout
+         * of every manager stay as they are, so any number of threads can
+         * call the const member functions (is_alive, has_component,
+         * get_component, signature, query, etc.) and iterate over views,
+         * groups and cached queries created before the phase, without locks.
+         * 
+         * Threads may also modify the components they get (get_component,
+         * storage<T>()->get, views) or patch them as long as no two threads
+         * access the same component and at least one of them writes it. The
+         * update listeners of a patched component run on the patching thread
+         * thus, they must be thread-safe (e.g. an Observer isn't).
+         * 
+         * Anything that changes the structure (creating or killing entities,
+         * bind, unbind, erase, sort, creating managers, groups, cached
+         * queries or listeners) is a bug during a read phase and it is caught
+         * by an assertion on debug builds. Record such changes on a
+         * CommandBuffer per thread and flush them after thaw.
+         * 
+         * Calling freeze and thaw must be synchronized with the threads (e.g.
+         * before submitting the tasks and after waiting for them).
+         */
+        inline void freeze() noexcept
+        {
+            frozen_ = true;
+        }
+
+        /**
+         * End the read phase started by freeze.
+         */
+        inline void thaw() noexcept
+        {
+            frozen_ = false;
+        }
+
+        /**
+         * Check if the registry is on a read phase (see freeze).
+         */
+        inline bool frozen() const noexcept
+        {
+            return frozen_;
+        }
+
+        /**
+         * Get the memory and occupancy of every component manager, e.g. to
+         * find bloated pools when the frame time spikes. It is computed on
+         * demand thus, it doesn't cost anything until it's called.
+         * 
+         * @returns the statistics of every manager (their type is the TypeIndex
+         * of the component).
+         */
+        std::vector<PoolStats> pool_stats() const
+        {
+            std::vector<PoolStats> result{};
+
+            for(id_t type = 0; type < component_managers_.size(); ++type)
+            {
+                if(!component_managers_[type])
+                    continue;
+
+                // every storage is a sparse set.
+                result.push_back(static_cast<const BasicSparseSet&>(*component_managers_[type]).stats());
+                result.back().type = type;
+            }
+
+            return result;
+        }
+
+#ifdef ENTIS_ENABLE_STATS
+        /**
+         * Get the counters of the structural changes (only with ENTIS_ENABLE_STATS).
          */
-        Registry()
-        : current_{MAX_ID},
-          entities_{},
-          component_managers_{}
+        inline const RegistryStats& stats() const noexcept
         {
+            return stats_;
+        }
 
+        /**
+         * Set the counters of the structural changes to zero (only with ENTIS_ENABLE_STATS).
+         */
+        inline void reset_stats() noexcept
+        {
+            stats_ = RegistryStats{};
         }
+#endif
 
         /**
          * Create a new entity.
          * 
          * It returns an entity that is either a recycled one
          * (an entity that was killed) or brand new one (an entity
-         * that hasn't been used before).
+         * that hasn't been used before). Recycled entities reuse the
+         * index of a killed entity with its version increased so, 
+         * handles to the killed entity don't refer to the new one.
          * 
-         * @returns a new entity that has no components attached to it.
+         * @returns a new entity that has no components attached to it or
+         * the null entity (MAX_ID) when every index is in use.
          */ 
         inline id_t make_entity()
         {
-            return (current_ == MAX_ID) ? make_new_entity() : recycle_entity();
+            assert_writable();
+
+            return created((current_ == NULL_INDEX) ? make_new_entity() : recycle_entity());
+        }
+
+        /**
+         * Create several entities at once.
+         * 
+         * Killed entities are recycled first, then the vector of entities
+         * grows once for the rest of them.
+         * 
+         * @tparam OutputIt an output iterator of entities (id_t).
+         * 
+         * @param count the number of entities to create.
+         * @param out where the new entities are written.
+         * 
+         * @returns the output iterator past the last written entity.
+         */
+        template <typename OutputIt>
+        OutputIt create(size_t count, OutputIt out)
+        {
+            assert_writable();
+
+            for(; count > 0 && current_ != NULL_INDEX; --count)
+                *out++ = created(recycle_entity());
+
+            entities_.reserve(entities_.size() + count);
+            signatures_.reserve(entities_.size() + count);
+
+            for(; count > 0; --count)
+                *out++ = created(make_new_entity());
+
+            return out;
         }
 
         /**
          * Check if an entity is alive (its currently available to be used).
          * 
+         * An entity is alive when the slot of its index holds the entity itself
+         * (same index and version) thus stale handles are detected with a 
+         * single load.
+         * 
          * @param entity the entity we want to test.
          * 
          * @return whether or not it is alive. 
          */
         inline bool is_alive(const id_t entity) const
         {
-            return entity < entities_.size() && entities_[entity] == entity;
+            const id_t index = to_index(entity);
+
+            return index < entities_.size() && entities_[index] == entity;
         }
 
         /**
          * Mark as dead the specified alive entity and remove all 
          * of its components.
          * 
+         * Only the managers of the components the entity has (its signature)
+         * are visited, regardless of the number of component types.
+         * 
          * @param entity the entity to kill.
          */ 
         void kill_entity(const id_t entity)
-        {   
+        {
+            assert_writable();
+
             if(is_alive(entity))
             {
+                if(!kill_hook_.empty())
+                    kill_hook_.publish(*this, entity);
+
+                ENTIS_STATS(++stats_.killed;)
+
                 mark_as_death(entity);
+
+                for(const std::unique_ptr<IGroup>& group : groups_)
+                    group->on_unbind(entity);
+
+                for(const std::unique_ptr<ICachedQuery>& query : queries_)
+                {
+                    if(query)
+                        query->remove(entity);
+                }
+
                 delete_all_components(entity);
             }
         }
 
+        /**
+         * Kill every alive entity on a range (dead entities are ignored).
+         * 
+         * @tparam It a forward iterator over entities (id_t).
+         * 
+         * @param first the first entity of the range.
+         * @param last the end of the range.
+         */
+        template <typename It>
+        void destroy(It first, It last)
+        {
+            for(; first != last; ++first)
+                kill_entity(*first);
+        }
+
+        /**
+         * Move the alive entities to the lowest indices and release the memory
+         * the managers no longer need (e.g. after killing a wave of entities).
+         * 
+         * Each alive entity past the first dead index is relabeled: it gets the
+         * lowest dead index (with the version it would have once recycled) and
+         * its old index is marked as dead. Old handles are then dead, never an
+         * alias of another entity. The components keep their position on the
+         * packed arrays, only their keys change, so groups and sorted
+         * managers keep their order. Afterwards, killed indices are recycled
+         * from the lowest one (when some entity was relabeled), the unused
+         * pages of the sparse arrays are freed and the packed arrays are shrunk.
+         * 
+         * The relabeled entities aren't killed nor created again, on_relabel
+         * is published instead (observers and trackers follow it) and fn must
+         * update every other stored handle:
+         * 
+         * registry.compact([&](id_t from, id_t to){ targets.replace(from, to); });
+         * 
+         * The work can be spread across frames with a time budget, the call
+         * returns when it runs out and a later call continues (the relabeled
+         * entities are valid in between):
+         * 
+         * done = registry.compact(remap, std::chrono::milliseconds{1});
+         * 
+         * Holes of components with in_place_delete aren't removed since their
+         * values must keep their address (see SparseSet::compact).
+         * 
+         * @tparam Fn a callable with the signature fn(id_t from, id_t to).
+         * 
+         * @param fn the function called for every relabeled entity, it
+         * mustn't change the registry.
+         * @param budget the maximum time spent relabeling entities.
+         * 
+         * @returns true if the alive entities are on the lowest indices and
+         * the memory was released, false if the budget ran out before.
+         */
+        template <typename Fn>
+        bool compact(Fn&& fn, const std::chrono::nanoseconds budget = std::chrono::nanoseconds::max())
+        {
+            assert_writable();
+
+            using Clock = std::chrono::steady_clock;
+
+            const bool timed = budget != std::chrono::nanoseconds::max();
+            const Clock::time_point deadline = timed ? Clock::now() + budget : Clock::time_point::max();
+
+            size_t low = 0;
+            size_t high = entities_.size();
+            size_t relabeled = 0;
+            bool moved = false;
+            bool done = true;
+
+            while(true)
+            {
+                while(low < high && is_alive_slot(low))
+                    ++low;
+
+                while(high > low && !is_alive_slot(high - 1))
+                    --high;
+
+                if(low >= high)
+                    break;
+
+                // the clock is only read every few entities.
+                if(timed && (++relabeled % 64) == 0 && Clock::now() >= deadline)
+                {
+                    done = false;
+                    break;
+                }
+
+                const id_t from = entities_[high - 1];
+                const id_t to = make_id(static_cast<id_t>(low), to_version(entities_[low]));
+
+                relabel(from, to);
+
+                fn(from, to);
+
+                moved = true;
+            }
+
+            // only when needed, so a DeltaLoader replaying the relabels ends up with the same list.
+            if(moved)
+                rebuild_free_list();
+
+            if(done)
+            {
+                for(const std::unique_ptr<IComponentManager>& manager : component_managers_)
+                {
+                    // every storage is a sparse set.
+                    if(manager)
+                        static_cast<BasicSparseSet&>(*manager).shrink_to_fit();
+                }
+
+                entities_.shrink_to_fit();
+                signatures_.shrink_to_fit();
+            }
+
+            return done;
+        }
+
+        /**
+         * Move the alive entities to the lowest indices and release the memory
+         * the managers no longer need (see compact(fn, budget)), for
+         * registries whose handles aren't stored anywhere else.
+         */
+        inline void compact()
+        {
+            compact([](const id_t, const id_t){});
+        }
+
+        /**
+         * Get the signature of an alive entity, this is, the set of the
+         * types (TypeIndex) of the components it has.
+         * 
+         * @param entity an alive entity.
+         * 
+         * @returns a const reference to the signature of the entity.
+         */
+        inline const Signature& signature(const id_t entity) const noexcept
+        {
+            return signatures_[to_index(entity)];
+        }
+
         /**
          * Check if an entity has a component T. 
          * 
@@ -98,7 +440,7 @@ namespace entis
         template <typename T>
         bool has_component(const id_t entity) const
         {
-            ComponentManager<T> manager = get_component_manager<T>();
+            const ComponentManager<T> manager = get_component_manager<T>();
 
             return manager ? manager->has_data(entity) : false;
         }
@@ -116,9 +458,39 @@ namespace entis
         template <typename T>
         Component<T> get_component(const id_t entity) const
         {
+            static_assert(!is_soa_v<T>, "SoA components are accessed through their fields (storage<T>()->field<I>())");
+
             Component<T> component{};
 
-            ComponentManager<T> manager = get_component_manager<T>();
+            const ComponentManager<T> manager = get_component_manager<T>();
+
+            if(manager)
+            {
+                component = manager->get_data(entity);
+            }
+
+            return component;
+        }
+
+        /**
+         * Get the T component of an entity if any so it can be modified
+         * in place (e.g. without binding a new instance).
+         * 
+         * @tparam T the type of the component we want to retrieve.
+         * 
+         * @param entity the entity whose component T we want to retrieve.
+         * 
+         * @returns an optional to a mutable reference to the component T when 
+         * it exists and an empty optional otherwise.
+         */
+        template <typename T>
+        MutableComponent<T> get_component(const id_t entity)
+        {
+            static_assert(!is_soa_v<T>, "SoA components are accessed through their fields (storage<T>()->field<I>())");
+
+            MutableComponent<T> component{};
+
+            const ComponentManager<T> manager = get_component_manager<T>();
 
             if(manager)
             {
@@ -128,6 +500,56 @@ namespace entis
             return component;
         }
 
+        /**
+         * Get the T components of several entities at once, faster than
+         * calling get_component for each of them when the entities are
+         * scattered: the lookups are prefetched in batches (see
+         * SparseSet::get_many).
+         * 
+         * std::vector<Transform*> transforms(targets.size());
+         * 
+         * registry.get_many<Transform>(targets.begin(), targets.end(), transforms.begin());
+         * 
+         * @tparam T the type of the components (neither a SoA component nor a tag).
+         * @tparam It a random access iterator over entities (id_t).
+         * @tparam OutputIt an output iterator of pointers to T.
+         * 
+         * @param first the first entity of the range.
+         * @param last the end of the range.
+         * @param out where the components are written (nullptr for the entities
+         * that don't have one), one per entity.
+         * 
+         * @returns the output iterator past the last written component.
+         */
+        template <typename T, typename It, typename OutputIt>
+        OutputIt get_many(It first, It last, OutputIt out)
+        {
+            static_assert(!is_soa_v<T> && !is_tag_v<T>, "only components stored on a SparseSet can be batched");
+
+            const ComponentManager<T> manager = get_component_manager<T>();
+
+            if(manager)
+                return manager->get_many(first, last, out);
+
+            return std::fill_n(out, std::distance(first, last), nullptr);
+        }
+
+        /**
+         * Const version of get_many, it writes pointers to const T.
+         */
+        template <typename T, typename It, typename OutputIt>
+        OutputIt get_many(It first, It last, OutputIt out) const
+        {
+            static_assert(!is_soa_v<T> && !is_tag_v<T>, "only components stored on a SparseSet can be batched");
+
+            const Storage<T>* manager = get_component_manager<T>();
+
+            if(manager)
+                return manager->get_many(first, last, out);
+
+            return std::fill_n(out, std::distance(first, last), nullptr);
+        }
+
         /**
          * Associate an alive entity with a new instace of T if it 
          * doesn't have a component associated with it already, update 
@@ -150,154 +572,701 @@ namespace entis
         template <typename T, typename... Args>
         BindResult bind(const id_t entity, Args&&... args)
         {
+            assert_writable();
+
             if (!is_alive(entity))
             {
                 return std::optional<error::BindError>{error::BindError::DEAD_ENTITY};
             }
 
-            ComponentManager<T> manager = get_component_manager<T>();
+            const ComponentManager<T> manager = storage<T>();
+            const ComponentHooks* hooks = find_hooks<T>();
 
-            if(!manager)
+            // only probed when someone listens.
+            const bool replaced = hooks && manager->has_data(entity);
+
+            BindResult result = manager->bind(entity, std::forward<Args>(args)...);
+
+            if(!result)
             {
-               manager = make_component_manager<T>();
+                on_bound<T>(entity);
+
+                if(hooks)
+                    (replaced ? hooks->update : hooks->construct).publish(*this, entity);
             }
 
-            return manager->bind(entity, args...);
+            return result;
         }
 
         /**
-         * Delete the association between an entity and its component
-         * T if any.
+         * Modify in place the T component of an entity if any.
          * 
-         * @tparam T the type of the component whose association we want to delete.
-         *
-         * @param entity the entity whose association we want to delete.
+         * Unlike binding a new instance, the component isn't constructed
+         * again thus, no temporaries (or allocations) are made:
          * 
-         * @returns an optional containing the component T whose association
-         * we just deleted (if any).
+         * registry.patch<Position>(entity, [](Position& p){ p.x += 1.0f; });
+         * 
+         * @tparam T the type of the component we want to modify.
+         * @tparam Fn a callable with the signature fn(T&).
+         * 
+         * @param entity the entity whose component we want to modify.
+         * @param fn the function applied to the component.
+         * 
+         * @returns true if the entity has a component T (and fn was applied),
+         * false otherwise.
          */
-        template <typename T>
-        std::optional<T> unbind(const id_t entity)
+        template <typename T, typename Fn>
+        bool patch(const id_t entity, Fn&& fn)
         {
-            ComponentManager<T> manager = get_component_manager<T>();
+            // allowed on read phases, the layout of the manager doesn't change.
+            const ComponentManager<T> manager = get_component_manager<T>();
 
-            std::optional<T> component{};
+            if(!manager || !manager->patch(entity, std::forward<Fn>(fn)))
+                return false;
 
-            if(manager)
-            {
-                component = manager->unbind(entity);
-            }
+            if(const ComponentHooks* hooks = find_hooks<T>())
+                hooks->update.publish(*this, entity);
 
-            return component;
+            return true;
         }
 
         /**
-         * Get a list of entities that have a component T.
+         * Associate every alive entity on a range with a new instance of T
+         * created from the same parameters (or update their component).
          * 
-         * @tparam the type of the component we want our entities 
-         * to have.
+         * The manager grows once for the whole range instead of once per entity.
          * 
-         * @return a list of entities that have a component T.
+         * @tparam T the type of the component we want to bind.
+         * @tparam It a forward iterator over entities (id_t).
+         * @tparam ...Args a packed list of values that will be passed to the 
+         * constructor of T for every entity.
+         * 
+         * @param first the first entity of the range.
+         * @param last the end of the range.
+         * 
+         * @returns an empty optional when the binding operation is successful and
+         * a BindError::DEAD_ENTITY when the range contains dead entities (the alive
+         * ones are bound anyway).
          */
-        template<typename T>
-        std::vector<id_t> entities_with_component() const
+        template <typename T, typename It, typename... Args>
+        BindResult bind_range(It first, It last, const Args&... args)
         {
-            ComponentManager<T> manager = get_component_manager<T>();
+            assert_writable();
 
-            std::vector<id_t> entities{};
+            BindResult result{};
 
-            if(manager)
+            const ComponentManager<T> manager = storage<T>();
+            const ComponentHooks* hooks = find_hooks<T>();
+
+            manager->reserve(manager->size() + static_cast<size_t>(std::distance(first, last)));
+
+            for(; first != last; ++first)
             {
-                std::copy_if(entities_.begin(), entities_.end(), std::back_inserter(entities),
-                    [&manager](const id_t entity)
+                const id_t entity = *first;
+
+                if(!is_alive(entity))
+                {
+                    result = error::BindError::DEAD_ENTITY;
+                }
+                else
+                {
+                    const bool replaced = hooks && manager->has_data(entity);
+
+                    if(!manager->bind(entity, args...))
                     {
-                        return manager->has_data(entity);
-                    });
+                        on_bound<T>(entity);
+
+                        if(hooks)
+                            (replaced ? hooks->update : hooks->construct).publish(*this, entity);
+                    }
+                }
             }
 
-            return entities;
+            return result;
         }
 
         /**
-         * Get all the specified components of an entity if any.
-         * 
-         * @tparam Components all the components of the specified 
-         * entity that we want to retrieve.
-         * 
-         * @param entity the entity whose components we want to retieve.
+         * Associate every alive entity on a range with the component at
+         * the same position on a second range.
          * 
-         * @returns a tuple of optionals of references to the specified types.
-         * (e.g. tuple<optional<reference_wrapp<int>, optional<reference_wrapp<string>>).
-         */
-        template <typename... Components>
-        auto get_components(const id_t entity) const
-        {
-            return std::make_tuple(get_component<Components>(entity) ...);
-        }
-
-        /**
-         * Get the specified components of all the entities that satisfy the query params,
-         * this is, the list of components that the entities must have and the ones it
-         * mustn't have.
+         * The manager grows once for the whole range instead of once per entity.
          * 
-         * @tparam WithComponents a type_list_t declaration containing the types of the
-         * components that the entities must have.
+         * @tparam T the type of the component we want to bind.
+         * @tparam It a forward iterator over entities (id_t).
+         * @tparam ValueIt an iterator over values of type T.
          * 
-         * @tparam WithoutComponents a type_list_t declaration containing the types of the
-         * components that the entities mustn't have.
+         * @param first the first entity of the range.
+         * @param last the end of the range.
+         * @param values the first value, there must be as many values as entities.
          * 
-         * @return a vector of tuples of references to the specified components of the entities
-         * that satisfy the query.
+         * @returns an empty optional when the binding operation is successful and
+         * a BindError::DEAD_ENTITY when the range contains dead entities (the alive
+         * ones are bound anyway).
          */
-        template <typename WithComponents, typename WithoutComponents = typing::type_list_t<>>
-        QueryResult<WithComponents> query() const
+        template <typename T, typename It, typename ValueIt>
+        BindResult insert(It first, It last, ValueIt values)
         {
-            // This vectors should be already sorted as the entity array appends values
-            // incrementally (e.g. 0, 1, 2, 3, etc.). Also, note that when killing 
-            // an entity the entity array is not sorted anymore but, since they don't
-            // have any component, the evaluation will always be false thus leaving
-            // only sorted results.
-            std::vector<id_t> desired_entities = with_components<WithComponents>();
-            std::vector<id_t> undesirable_entities = with_components<WithoutComponents>();
+            assert_writable();
 
-            std::vector<id_t> required_entities{};
+            BindResult result{};
 
-            // leave only the desired entities.
-            std::set_difference(desired_entities.begin(), desired_entities.end(),
-                                undesirable_entities.begin(), undesirable_entities.end(),
-                                std::inserter(required_entities, required_entities.begin()));
+            const ComponentManager<T> manager = storage<T>();
+            const ComponentHooks* hooks = find_hooks<T>();
 
-            QueryResult<WithComponents> result{};
+            manager->reserve(manager->size() + static_cast<size_t>(std::distance(first, last)));
 
-            std::transform(required_entities.begin(), required_entities.end(), std::back_inserter(result),
-            [this](const id_t entity)
+            for(; first != last; ++first, ++values)
             {
-                return TypeListHelper<WithComponents>::convert_and_unwrapp(*this, entity);
-            });
+                const id_t entity = *first;
 
-            return result;
-        }
+                if(!is_alive(entity))
+                {
+                    result = error::BindError::DEAD_ENTITY;
+                }
+                else
+                {
+                    const bool replaced = hooks && manager->has_data(entity);
+
+                    if(!manager->bind(entity, *values))
+                    {
+                        on_bound<T>(entity);
+
+                        if(hooks)
+                            (replaced ? hooks->update : hooks->construct).publish(*this, entity);
+                    }
+                }
+            }
+
+            return result;
+        }
+
+        /**
+         * Allocate enough space on the manager of a component T to hold
+         * the specified number of components without growing (e.g. when
+         * loading a level).
+         * 
+         * @tparam T the type of the component.
+         * 
+         * @param capacity the number of components.
+         */
+        template <typename T>
+        void reserve(const size_t capacity)
+        {
+            assert_writable();
+
+            storage<T>()->reserve(capacity);
+        }
+
+        /**
+         * Sort the components T (and the entities that own them), views
+         * driven by T visit them in the new order.
+         * 
+         * @tparam T the type of the components to sort (owned by no group).
+         * @tparam Compare a callable with the signature compare(const T&, const T&)
+         * or compare(id_t, id_t) that returns true if the first argument goes first.
+         * @tparam Sort the sorting algorithm (StdSort, or InsertionSort for
+         * components that are nearly sorted already).
+         * 
+         * @param compare the comparison function.
+         * @param algorithm the sorting algorithm.
+         */
+        template <typename T, typename Compare, typename Sort = StdSort>
+        void sort(Compare compare, Sort algorithm = Sort{})
+        {
+            static_assert(!is_soa_v<T> && !is_tag_v<T>, "only components stored on a SparseSet can be sorted");
+
+            assert(owner<T>() == nullptr && "the order of owned components belongs to their group");
+
+            assert_writable();
+
+            storage<T>()->sort(std::move(compare), std::move(algorithm));
+        }
+
+        /**
+         * Arrange the components T of the entities that also have a component
+         * Other in the same order as the Other components, so iterating over
+         * both types at the same time is sequential.
+         * 
+         * @tparam T the type of the components to arrange (owned by no group).
+         * @tparam Other the type of the components whose order will be followed.
+         */
+        template <typename T, typename Other>
+        void sort_as()
+        {
+            static_assert(!is_soa_v<T>, "SoA components can't be sorted");
+
+            assert(owner<T>() == nullptr && "the order of owned components belongs to their group");
+
+            assert_writable();
+
+            storage<T>()->sort_as(*storage<Other>());
+        }
+
+        /**
+         * Delete the association between an entity and its component
+         * T if any.
+         * 
+         * @tparam T the type of the component whose association we want to delete.
+         *
+         * @param entity the entity whose association we want to delete.
+         * 
+         * @returns an optional containing the component T whose association
+         * we just deleted (if any).
+         */
+        template <typename T>
+        std::optional<T> unbind(const id_t entity)
+        {
+            assert_writable();
+
+            const ComponentManager<T> manager = get_component_manager<T>();
+
+            std::optional<T> component{};
+
+            if(manager && manager->has_data(entity))
+            {
+                on_unbinding<T>(entity);
+
+                if(const ComponentHooks* hooks = find_hooks<T>())
+                    hooks->destroy.publish(*this, entity);
+
+                component = manager->unbind(entity);
+
+                refresh_queries<T>(entity);
+            }
+
+            return component;
+        }
+
+        /**
+         * Delete the association between an entity and its component
+         * T if any, without passing the component to the caller (cheaper
+         * than unbind when the component isn't needed).
+         * 
+         * @tparam T the type of the component whose association we want to delete.
+         *
+         * @param entity the entity whose association we want to delete.
+         * 
+         * @returns true if the entity had a component T, false otherwise.
+         */
+        template <typename T>
+        bool erase(const id_t entity)
+        {
+            assert_writable();
+
+            const ComponentManager<T> manager = get_component_manager<T>();
+
+            if(!manager || !manager->has_data(entity))
+                return false;
+
+            on_unbinding<T>(entity);
+
+            if(const ComponentHooks* hooks = find_hooks<T>())
+                hooks->destroy.publish(*this, entity);
+
+            manager->erase(entity);
+
+            refresh_queries<T>(entity);
+
+            return true;
+        }
+
+        /**
+         * Get a list of entities that have a component T.
+         * 
+         * @tparam the type of the component we want our entities 
+         * to have.
+         * 
+         * @return a list of entities that have a component T.
+         */
+        template<typename T>
+        std::vector<id_t> entities_with_component() const
+        {
+            const ComponentManager<T> manager = get_component_manager<T>();
+
+            std::vector<id_t> entities{};
+
+            if(manager)
+            {
+                entities.assign(manager->keys().begin(), manager->keys().end());
+
+                // skip the holes of paged managers.
+                if constexpr(Storage<T>::in_place_delete)
+                    entities.erase(std::remove(entities.begin(), entities.end(), MAX_ID), entities.end());
+            }
+
+            return entities;
+        }
+
+        /**
+         * Get all the specified components of an entity if any.
+         * 
+         * @tparam Components all the components of the specified 
+         * entity that we want to retrieve.
+         * 
+         * @param entity the entity whose components we want to retieve.
+         * 
+         * @returns a tuple of optionals of references to the specified types.
+         * (e.g. tuple<optional<reference_wrapp<int>, optional<reference_wrapp<string>>).
+         */
+        template <typename... Components>
+        auto get_components([[maybe_unused]] const id_t entity) const
+        {
+            return std::make_tuple(get_component<Components>(entity) ...);
+        }
+
+        /**
+         * Get all the specified components of an entity if any so they can
+         * be modified in place.
+         * 
+         * @tparam Components all the components of the specified 
+         * entity that we want to retrieve.
+         * 
+         * @param entity the entity whose components we want to retieve.
+         * 
+         * @returns a tuple of optionals of mutable references to the specified types.
+         */
+        template <typename... Components>
+        auto get_components([[maybe_unused]] const id_t entity)
+        {
+            return std::make_tuple(get_component<Components>(entity) ...);
+        }
+
+        /**
+         * Get the manager (SparseSet<T>, SoASet<T> or TagSet<T>, see Storage) of a 
+         * component T, creating it if it doesn't exist yet.
+         * 
+         * The returned handle stays valid for the lifetime of the registry
+         * so it can be cached by the caller to skip the lookup entirely. Keep
+         * in mind that binding or unbinding through the handle bypasses the 
+         * registry (e.g. groups and signatures aren't updated, which views rely
+         * on) thus, it must only be used for accessing the components.
+         * 
+         * @tparam T the type of the component whose manager we want.
+         * 
+         * @returns a pointer to the manager of the component T (never null).
+         */
+        template <typename T>
+        ComponentManager<T> storage()
+        {
+            ComponentManager<T> manager = get_component_manager<T>();
+
+            if(!manager)
+            {
+               manager = make_component_manager<T>();
+            }
+
+            return manager;
+        }
+
+        /**
+         * Get the signal published right after a component T is bound to an
+         * entity that didn't have one (bind, bind_range and insert).
+         * 
+         * Listeners are called with the registry and the entity, the new
+         * component is already accessible:
+         * 
+         * registry.on_construct<Transform>().connect([](Registry& registry, id_t entity){ ... });
+         * 
+         * The signals only cover the changes made through the registry, modifying
+         * a component through get_component or storage<T>() isn't published (use
+         * patch instead). Listeners mustn't bind nor unbind components T.
+         * 
+         * @tparam T the type of the component.
+         * 
+         * @returns a reference to the signal (stable for the lifetime of the registry).
+         */
+        template <typename T>
+        Hook& on_construct()
+        {
+            return hooks<T>().construct;
+        }
+
+        /**
+         * Get the signal published right after the component T of an entity
+         * is patched or replaced by binding a new instance.
+         * 
+         * @tparam T the type of the component.
+         * 
+         * @returns a reference to the signal (stable for the lifetime of the registry).
+         */
+        template <typename T>
+        Hook& on_update()
+        {
+            return hooks<T>().update;
+        }
+
+        /**
+         * Get the signal published right before the component T of an entity
+         * is removed (unbind, erase and kill_entity), the component is still
+         * accessible. When the entity is killed it is already dead at that point.
+         * 
+         * @tparam T the type of the component.
+         * 
+         * @returns a reference to the signal (stable for the lifetime of the registry).
+         */
+        template <typename T>
+        Hook& on_destroy()
+        {
+            return hooks<T>().destroy;
+        }
+
+        /**
+         * Get the signal published right after an entity is created (make_entity
+         * and create).
+         * 
+         * @returns a reference to the signal.
+         */
+        inline Hook& on_create() noexcept
+        {
+            assert_writable();
+
+            return create_hook_;
+        }
+
+        /**
+         * Get the signal published right before an entity is killed, the
+         * entity is still alive and has all of its components.
+         * 
+         * @returns a reference to the signal.
+         */
+        inline Hook& on_kill() noexcept
+        {
+            assert_writable();
+
+            return kill_hook_;
+        }
+
+        /**
+         * Get the signal published right after an entity is relabeled by
+         * compact, with its old and its new identifier. Its components and
+         * signature already moved to the new identifier.
+         * 
+         * @returns a reference to the signal.
+         */
+        inline RelabelHook& on_relabel() noexcept
+        {
+            assert_writable();
+
+            return relabel_hook_;
+        }
+
+        /**
+         * Get the specified components of all the entities that satisfy the query params,
+         * this is, the list of components that the entities must have and the ones it
+         * mustn't have.
+         * 
+         * @tparam WithComponents a type_list_t declaration containing the types of the
+         * components that the entities must have.
+         * 
+         * @tparam WithoutComponents a type_list_t declaration containing the types of the
+         * components that the entities mustn't have.
+         * 
+         * @return a vector of tuples of references to the specified components of the entities
+         * that satisfy the query (in the order of the smallest WithComponents manager).
+         */
+        template <typename WithComponents, typename WithoutComponents = typing::type_list_t<>>
+        QueryResult<WithComponents> query() const
+        {
+            QueryResult<WithComponents> result{};
+
+            if constexpr(!typing::is_empty<WithComponents>::value)
+            {
+                const View<WithComponents, typing::unique<WithoutComponents>> view = 
+                    make_view(WithComponents{}, typing::unique<WithoutComponents>{});
+
+                result.reserve(view.size_hint());
+
+                view.each([&result](const id_t, const auto&... components)
+                {
+                    result.emplace_back(std::cref(components)...);
+                });
+            }
+
+            return result;
+        }
+
+        /**
+         * Create a lazy, non-allocating view over the entities that have all the 
+         * specified components and none of the excluded ones. 
+         * 
+         * Unlike query, the view doesn't store its result thus, it's cheap to 
+         * create and can be iterated with a range-for (structured bindings yield
+         * the entity and references to its components) or with each:
+         * 
+         * for(auto [entity, position, velocity] : registry.view<Position, Velocity>(exclude<Dead>))
+         * 
+         * registry.view<Position, Velocity>().each([](id_t entity, Position& p, Velocity& v){ ... });
+         * 
+         * @tparam Components the types of the components the entities must have.
+         * @tparam Excluded the types of the components the entities mustn't have.
+         * 
+         * @returns a view over the entities that satisfy the query.
+         */
+        template <typename... Components, typename... Excluded>
+        View<typing::type_list_t<Components...>, typing::unique<typing::type_list_t<Excluded...>>> view(
+            exclude_t<Excluded...> = {})
+        {
+            return make_view(typing::type_list_t<Components...>{}, typing::unique<typing::type_list_t<Excluded...>>{});
+        }
+
+        /**
+         * Create a group that owns the specified components or get it if it
+         * was already created.
+         * 
+         * A group keeps the entities that have all the owned components at the 
+         * front of the packed arrays of their managers and in the same order so,
+         * iterating over it is a linear scan over the packed arrays without any
+         * lookup. The group is updated on bind, unbind and kill_entity.
+         * 
+         * A component can only be owned by a single group.
+         * 
+         * @tparam Owned the types of the components the group will own (at least two).
+         * 
+         * @returns a handle used to iterate over the entities of the group.
+         */
+        template <typename... Owned>
+        Group<Owned...> group()
+        {
+            static_assert(((!is_soa_v<Owned> && !is_tag_v<Owned>) && ...), "a group can't own SoA components nor tags");
+
+            using Type = OwningGroup<Owned...>;
+
+            IGroup* current = owner<typing::front<typing::type_list_t<Owned...>>>();
+
+            Type* owning_group = (current && current->type() == BasicTypeIndex<detail::GroupFamily>::get<Type>()) ? 
+                static_cast<Type*>(current) : nullptr;
+
+            if(!owning_group)
+            {
+                assert_writable();
+
+                // a component can't be owned by two groups.
+                assert(((owner<Owned>() == nullptr) && ...));
+
+                auto new_group = std::make_unique<Type>(
+                    std::tuple<SparseSet<Owned>*...>{ storage<Owned>() ... });
+
+                owning_group = new_group.get();
+
+                (set_owner<Owned>(owning_group), ...);
+
+                groups_.push_back(std::move(new_group));
+            }
+
+            return Group<Owned...>{*owning_group};
+        }
+
+        /**
+         * Get a query whose matching entities are stored and kept up to date
+         * on every bind, unbind and kill_entity of its components (see 
+         * cached_query.h), creating it if it doesn't exist yet.
+         * 
+         * Unlike query and view, the matching entities aren't searched for
+         * every time thus, iterating over it costs the number of matches:
+         * 
+         * auto& moving = registry.cached_query<Position, Velocity>(exclude<Frozen>);
+         * 
+         * moving.each([](id_t entity, Position& p, const Velocity& v){ ... });
+         * 
+         * @tparam Components the types of the components the entities must have.
+         * @tparam Excluded the types of the components the entities mustn't have.
+         * 
+         * @returns a reference to the query (valid for the lifetime of the registry).
+         */
+        template <typename... Components, typename... Excluded>
+        CachedQuery<typing::type_list_t<Components...>, typing::unique<typing::type_list_t<Excluded...>>>& cached_query(
+            exclude_t<Excluded...> = {})
+        {
+            // repeated exclusions share the same query.
+            return make_cached_query(typing::type_list_t<Components...>{}, typing::unique<typing::type_list_t<Excluded...>>{});
+        }
+
+        /**
+         * Apply the structural changes recorded on a command buffer (see 
+         * command_buffer.h) and clear it.
+         * 
+         * @param buffer the buffer whose commands will be applied.
+         */
+        void flush(CommandBuffer& buffer);
 
     private:
 
-        id_t current_; // last deleted entity (mainly used on implicit list).
-        std::vector<id_t> entities_;
-        std::unordered_map<std::string, std::shared_ptr<IComponentManager>> component_managers_;
+        id_t current_; // index of the last deleted entity (head of the implicit list).
+        std::pmr::vector<id_t> entities_; // alive: the entity, dead: next dead index + next version.
+        std::pmr::vector<Signature> signatures_; // components of each entity (indexed by to_index).
+        std::vector<std::unique_ptr<IComponentManager>> component_managers_; // indexed by TypeIndex.
+        std::vector<std::unique_ptr<IGroup>> groups_;
+        std::vector<IGroup*> owners_; // group that owns a component (indexed by TypeIndex).
+
+        /**
+         * The signals of a component type.
+         */
+        struct ComponentHooks
+        {
+            Hook construct;
+            Hook update;
+            Hook destroy;
+        };
+
+        std::vector<std::unique_ptr<ComponentHooks>> hooks_; // indexed by TypeIndex, null without listeners.
+
+        std::vector<std::unique_ptr<ICachedQuery>> queries_; // indexed by the BasicTypeIndex<detail::QueryFamily> of the query.
+        std::vector<std::vector<ICachedQuery*>> watchers_;  // queries that use a component (indexed by TypeIndex).
+
+        Hook create_hook_;
+        Hook kill_hook_;
+        RelabelHook relabel_hook_;
+        bool frozen_; // whether the registry is on a read phase.
+
+#ifdef ENTIS_ENABLE_STATS
+        RegistryStats stats_;
+#endif
+
+        /**
+         * Check that the structure of the registry can be changed (it isn't
+         * on a read phase), only on debug builds.
+         */
+        inline void assert_writable() const noexcept
+        {
+            assert(!frozen_ && "the registry can't be changed during a read phase");
+        }
 
         /**
          * Create a brand new entity and add it to the
          * vector of entities.
          * 
-         * @returns the newly created entity.
+         * @returns the newly created entity (version 0) or the null
+         * entity when every index is in use.
          */
         inline id_t make_new_entity()
         {
-            id_t new_entity = entities_.size();
+            if(entities_.size() >= NULL_INDEX)
+                return MAX_ID;
+
+            id_t new_entity = make_id(static_cast<id_t>(entities_.size()), 0);
             entities_.push_back(new_entity);
+            signatures_.emplace_back();
 
             return new_entity;
         }
 
+        /**
+         * Publish the creation of an entity.
+         * 
+         * @param entity the new entity (or the null entity).
+         * 
+         * @returns the entity itself.
+         */
+        inline id_t created(const id_t entity)
+        {
+            ENTIS_STATS(stats_.created += (entity != MAX_ID);)
+
+            if(!create_hook_.empty() && entity != MAX_ID)
+                create_hook_.publish(*this, entity);
+
+            return entity;
+        }
+
         /**
          * Get the next entity of the implicit
          * list of dead entities for reuse.
@@ -306,35 +1275,305 @@ namespace entis
          */
         inline id_t recycle_entity()
         {   
-            id_t recycled_entity = current_;
-            current_ = entities_[recycled_entity];
-            entities_[recycled_entity] = recycled_entity;
+            const id_t index = current_;
+            const id_t slot = entities_[index];
+
+            current_ = to_index(slot);
+
+            // the slot already holds the increased version.
+            const id_t recycled_entity = make_id(index, to_version(slot));
+            entities_[index] = recycled_entity;
 
             return recycled_entity;
         }
 
+        /**
+         * Check if the slot of an index holds an alive entity (instead of a
+         * link of the list of dead entities).
+         * 
+         * @param index a valid index.
+         */
+        inline bool is_alive_slot(const size_t index) const noexcept
+        {
+            return to_index(entities_[index]) == index;
+        }
+
+        /**
+         * Give an alive entity the index of a dead one (see compact).
+         * 
+         * @param from the alive entity.
+         * @param to the new identifier, its index must be dead.
+         */
+        void relabel(const id_t from, const id_t to)
+        {
+            const id_t old_index = to_index(from);
+            const id_t new_index = to_index(to);
+
+            Signature& signature = signatures_[old_index];
+
+            signature.each([this, from, to](const id_t type)
+            {
+                static_cast<BasicSparseSet&>(*component_managers_[type]).relabel(from, to);
+            });
+
+            // types that don't fit on a signature are always visited.
+            for(id_t type = MAX_COMPONENTS; type < component_managers_.size(); ++type)
+            {
+                if(!component_managers_[type])
+                    continue;
+
+                BasicSparseSet& manager = static_cast<BasicSparseSet&>(*component_managers_[type]);
+
+                if(manager.has_data(from))
+                    manager.relabel(from, to);
+            }
+
+            for(const std::unique_ptr<ICachedQuery>& query : queries_)
+            {
+                if(query)
+                    query->relabel(from, to);
+            }
+
+            signatures_[new_index] = signature;
+            signature.clear();
+
+            entities_[new_index] = to;
+            entities_[old_index] = make_id(NULL_INDEX, to_version(from) + 1);
+
+            if(!relabel_hook_.empty())
+                relabel_hook_.publish(*this, from, to);
+        }
+
+        /**
+         * Link the dead entities in increasing order of their index so the
+         * lowest ones are recycled first, their versions are kept.
+         */
+        void rebuild_free_list()
+        {
+            current_ = NULL_INDEX;
+
+            for(size_t i = entities_.size(); i > 0; --i)
+            {
+                const size_t index = i - 1;
+
+                if(!is_alive_slot(index))
+                {
+                    entities_[index] = make_id(current_, to_version(entities_[index]));
+                    current_ = static_cast<id_t>(index);
+                }
+            }
+        }
+
         /**
          * Add the specified entity to the implicit list
-         * of dead entities.
+         * of dead entities, its slot stores the next dead index 
+         * along with the version the index will have once recycled.
          * 
          * @param entity the entity we want to kill.
          */
         inline void mark_as_death(const id_t entity)
         {
-            entities_[entity] = current_;
-            current_ = entity;
+            const id_t index = to_index(entity);
+
+            entities_[index] = make_id(current_, to_version(entity) + 1);
+            current_ = index;
+        }
+
+        /**
+         * Get the group that owns a component T.
+         * 
+         * @tparam T the type of the component.
+         * 
+         * @returns a pointer to the group that owns T or nullptr if
+         * it isn't owned.
+         */
+        template <typename T>
+        inline IGroup* owner() const noexcept
+        {
+            const id_t index = TypeIndex::get<T>();
+
+            return index < owners_.size() ? owners_[index] : nullptr;
+        }
+
+        /**
+         * Set the group that owns a component T.
+         * 
+         * @tparam T the type of the component.
+         * 
+         * @param group the group that will own T.
+         */
+        template <typename T>
+        void set_owner(IGroup* group)
+        {
+            const id_t index = TypeIndex::get<T>();
+
+            if(index >= owners_.size())
+                owners_.resize(index + 1, nullptr);
+
+            owners_[index] = group;
+        }
+
+        /**
+         * Get the signals of a component T, creating them if needed.
+         * 
+         * @tparam T the type of the component.
+         */
+        template <typename T>
+        ComponentHooks& hooks()
+        {
+            assert_writable();
+
+            const id_t index = TypeIndex::get<T>();
+
+            if(index >= hooks_.size())
+                hooks_.resize(index + 1);
+
+            if(!hooks_[index])
+                hooks_[index] = std::make_unique<ComponentHooks>();
+
+            return *hooks_[index];
+        }
+
+        /**
+         * Get the signals of a component type if some of them have listeners.
+         * 
+         * @param type the TypeIndex of the component.
+         * 
+         * @returns a pointer to the signals or nullptr when nobody listens
+         * (publishing is skipped entirely).
+         */
+        inline const ComponentHooks* find_hooks(const id_t type) const noexcept
+        {
+            if(type >= hooks_.size() || !hooks_[type])
+                return nullptr;
+
+            const ComponentHooks* hooks = hooks_[type].get();
+
+            return (hooks->construct.empty() && hooks->update.empty() && hooks->destroy.empty()) ? nullptr : hooks;
+        }
+
+        template <typename T>
+        inline const ComponentHooks* find_hooks() const noexcept
+        {
+            return find_hooks(TypeIndex::get<T>());
+        }
+
+        /**
+         * Update the registry bookkeeping after binding a new 
+         * component T to an entity.
+         * 
+         * @tparam T the type of the bound component.
+         * 
+         * @param entity the entity whose component was bound.
+         */
+        template <typename T>
+        inline void on_bound(const id_t entity)
+        {
+            ENTIS_STATS(++stats_.bound;)
+
+            signatures_[to_index(entity)].set(TypeIndex::get<T>());
+
+            if(IGroup* group = owner<T>())
+                group->on_bind(entity);
+
+            refresh_queries<T>(entity);
+        }
+
+        /**
+         * Update the registry bookkeeping before unbinding a
+         * component T from an entity.
+         * 
+         * @tparam T the type of the component to unbind.
+         * 
+         * @param entity the entity whose component will be unbound.
+         */
+        template <typename T>
+        inline void on_unbinding(const id_t entity)
+        {
+            ENTIS_STATS(++stats_.unbound;)
+
+            signatures_[to_index(entity)].reset(TypeIndex::get<T>());
+
+            if(IGroup* group = owner<T>())
+                group->on_unbind(entity);
+        }
+
+        /**
+         * Register a cached query as a user of a component T so it is
+         * refreshed whenever a T is bound or unbound.
+         * 
+         * @tparam T the type of the component.
+         * 
+         * @param query the query that uses T.
+         */
+        template <typename T>
+        void watch(ICachedQuery* query)
+        {
+            const id_t index = TypeIndex::get<T>();
+
+            if(index >= watchers_.size())
+                watchers_.resize(index + 1);
+
+            watchers_[index].push_back(query);
         }
 
         /**
-         * Deletes all the components of the specified entity.
+         * Test an entity again on the cached queries that use a component T
+         * after a T was bound to or unbound from it.
+         * 
+         * @tparam T the type of the component.
+         * 
+         * @param entity the entity whose component T changed.
+         */
+        template <typename T>
+        inline void refresh_queries(const id_t entity)
+        {
+            const id_t index = TypeIndex::get<T>();
+
+            if(index >= watchers_.size())
+                return;
+
+            for(ICachedQuery* query : watchers_[index])
+                query->refresh(entity);
+        }
+
+        /**
+         * Deletes all the components of the specified entity and clears
+         * its signature.
          * 
          * @param entity the entity whose component to delete.
          */
         void delete_all_components(const id_t entity)
         {
-            for(auto& entry : component_managers_)
+            Signature& signature = signatures_[to_index(entity)];
+
+            signature.each([this, entity](const id_t type)
+            {
+                ENTIS_STATS(++stats_.unbound;)
+
+                if(const ComponentHooks* hooks = find_hooks(type))
+                    hooks->destroy.publish(*this, entity);
+
+                component_managers_[type]->delete_component(entity);
+            });
+
+            signature.clear();
+
+            // types that don't fit on a signature are always visited.
+            for(id_t type = MAX_COMPONENTS; type < component_managers_.size(); ++type)
             {
-                entry.second->delete_component(entity);
+                if(!component_managers_[type])
+                    continue;
+
+                const ComponentHooks* hooks = find_hooks(type);
+
+                // every storage is a sparse set.
+                if(hooks && static_cast<const BasicSparseSet&>(*component_managers_[type]).has_data(entity))
+                    hooks->destroy.publish(*this, entity);
+
+                ENTIS_STATS(stats_.unbound += static_cast<const BasicSparseSet&>(*component_managers_[type]).has_data(entity);)
+
+                component_managers_[type]->delete_component(entity);
             }
         }
 
@@ -343,26 +1582,25 @@ namespace entis
          * 
          * @tparam T the type whose manager we want to retrieve
          * 
-         * @returns a shared_ptr to the corresponding manager (SparseSet<T>),
-         * if no manager has been created the pointer is empty.
+         * The registry keeps the ownership of the managers thus, a raw pointer
+         * is returned and the lookup doesn't touch any reference count (it's 
+         * safe to call it from several threads as long as no manager is created
+         * meanwhile).
+         * 
+         * @returns a pointer to the corresponding manager (see Storage),
+         * if no manager has been created the pointer is null.
          */
         template <typename T>
-        inline ComponentManager<T> get_component_manager() const
+        inline ComponentManager<T> get_component_manager() const noexcept
         {
-            ComponentManager<T> sparse_set{};
-
-            std::string type_name{typeid(T).name()};
-
-            if(component_managers_.find(type_name) != component_managers_.end())
-            {
-                sparse_set = std::static_pointer_cast<SparseSet<T>>(component_managers_.at(type_name));
-            }
+            const id_t index = TypeIndex::get<T>();
 
-            return sparse_set;
+            return index < component_managers_.size() ? 
+                static_cast<ComponentManager<T>>(component_managers_[index].get()) : nullptr;
         }
 
         /**
-         * Make a new component manager (SparseSet<T>).
+         * Make a new component manager (see Storage).
          * 
          * @tparam T the type of the component that the manager 
          * will administrate.
@@ -372,98 +1610,75 @@ namespace entis
         template <typename T>
         inline ComponentManager<T> make_component_manager()
         {
-            std::string type_name{typeid(T).name()};
+            assert_writable();
 
-            component_managers_[type_name] = std::make_shared<SparseSet<T>>();
+            const id_t index = TypeIndex::get<T>();
 
-            return std::static_pointer_cast<SparseSet<T>>(component_managers_.at(type_name));
+            if(index >= component_managers_.size())
+                component_managers_.resize(index + 1);
+
+            component_managers_[index] = std::make_unique<Storage<T>>(resource());
+
+            return static_cast<ComponentManager<T>>(component_managers_[index].get());
         }
 
         /**
-         * Get all entities that have all the components on a type_list_t.
+         * Get a cached query (see cached_query), creating it if it doesn't exist yet.
          * 
-         * @tparam Components a type_list_t declaration that contain the expected components.
+         * @tparam Components the types of the components the entities must have.
+         * @tparam Excluded the types of the components the entities mustn't have.
          * 
-         * @returns a sorted vector of entities where each of them is guaranteed to have
-         * all the components specified on the type_list_t.
+         * @returns a reference to the query.
          */
-        template <typename Components>
-        inline std::vector<id_t> with_components() const
+        template <typename... Components, typename... Excluded>
+        CachedQuery<typing::type_list_t<Components...>, typing::type_list_t<Excluded...>>& make_cached_query(
+            typing::type_list_t<Components...>, typing::type_list_t<Excluded...>)
         {
-            std::vector<id_t> result{};
+            using Type = CachedQuery<typing::type_list_t<Components...>, typing::type_list_t<Excluded...>>;
 
-            if(!typing::is_empty<Components>::value)
+            const id_t index = BasicTypeIndex<detail::QueryFamily>::get<Type>();
+
+            if(index >= queries_.size() || !queries_[index])
             {
-                std::copy_if(entities_.begin(), entities_.end(), std::back_inserter(result),
-                [this](const id_t entity)
-                {
-                    return TypeListHelper<Components>::has_components(*this, entity);
-                });
+                // nothing may grow before the check, not even the table.
+                assert_writable();
+
+                if(index >= queries_.size())
+                    queries_.resize(index + 1);
+
+                // the query keeps pointers to the managers thus, they must exist.
+                (storage<Components>(), ...);
+                (storage<Excluded>(), ...);
+
+                queries_[index] = std::make_unique<Type>(
+                    make_view(typing::type_list_t<Components...>{}, typing::type_list_t<Excluded...>{}),
+                    Signature::representable<Components..., Excluded...>() ? &signatures_ : nullptr, resource());
+
+                (watch<Components>(queries_[index].get()), ...);
+                (watch<Excluded>(queries_[index].get()), ...);
             }
 
-            return result;
+            return static_cast<Type&>(*queries_[index]);
         }
 
         /**
-         * Abstract class used to apply registry functions on a type_list_t.
-         * 
-         * @tparam List a type_list_t definition.
-         */
-        template <typename List>
-        class TypeListHelper
-        {
-        public:
-            /**
-             * Create a tuple containing references to the types specified on a type_list_t. 
-             * For example: 
-             * 
-             * type_list_t<int, string> -> 
-             * tuple<reference_wrapper<int>, reference_wrapper<string>>
-             * 
-             * @tparam List a type_list_t definition.
-             * 
-             * @param registry a registry instance used to get component instances.
-             * @param entity an entity whose components we want to retrieve.
-             * 
-             * @returns a tuple of reference wrappers to the specified types.
-             */
-            static auto convert_and_unwrapp(const Registry& registry, const id_t entity);
-
-            /**
-             * Check if an entity has all components specified on a type_list_t.
-             * 
-             * @tparam List a type_list_t definition.
-             * 
-             * @param registry a registry instance used to get check if an 
-             * entity has some components.
-             * @param entity the entity that we will test.
-             * 
-             * @returns true if the specified entity has all the specified components and
-             * false otherwise.
-             */
-            static bool has_components(const Registry& registry, const id_t entity);
-        };
-
-        /**
-         * Specialization used to convert a type_list_t into a parameter pack. 
+         * Create a view over the managers of the specified components.
+         * 
+         * @tparam With the components the entities must have.
+         * @tparam Without the components the entities mustn't have.
          * 
-         * @tparam List parameter pack containing the list of types specified on
-         * a type_list_t.
+         * @returns a view over the entities that satisfy the query.
          */
-        template <typename... List>
-        class TypeListHelper<typing::type_list_t<List...>>
+        template <typename... With, typename... Without>
+        inline View<typing::type_list_t<With...>, typing::type_list_t<Without...>> make_view(
+            typing::type_list_t<With...>, typing::type_list_t<Without...>) const
         {
-        public:
-            static auto convert_and_unwrapp(const Registry& registry, const id_t entity)
-            {
-                return std::make_tuple(registry.get_component<List>(entity).value() ...);
-            }
-
-            static bool has_components(const Registry& registry, const id_t entity)
-            {
-                return (registry.has_component<List>(entity) && ...);
-            }
-        };
+            // types that don't fit on a signature fall back to probing the managers.
+            return View<typing::type_list_t<With...>, typing::type_list_t<Without...>>{
+                std::tuple<Storage<With>*...>{ get_component_manager<With>() ... },
+                std::tuple<Storage<Without>*...>{ get_component_manager<Without>() ... },
+                Signature::representable<With..., Without...>() ? &signatures_ : nullptr};
+        }
     };
 }
 
@@ -0,0 +1,257 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <functional>
+
+#include "stats.h"
+#include "config.h"
+#include "registry.h"
+#include "type_list.h"
+#include "type_index.h"
+#include "thread_pool.h"
+
+namespace entis
+{
+    /**
+     * Runs systems (functions over a Registry) concurrently whenever their
+     * component accesses don't conflict.
+     *
+     * Each system declares the components it reads and the ones it writes.
+     * Two systems conflict when one of them writes a component the other one
+     * reads or writes, in that case they run in the order they were added,
+     * otherwise they may run at the same time. Because of this, the time of
+     * a frame is roughly the critical path of the dependency graph instead
+     * of the sum of all the systems.
+     *
+     * Systems that run at the same time must only access the components they
+     * declared and mustn't change the structure of the registry (make_entity,
+     * kill_entity, bind, unbind, etc.), those changes should be recorded and
+     * applied once run returns. Writing components in place (get_component,
+     * views or patch) is fine. The registry is frozen while the systems run
+     * so such changes are caught by an assertion on debug builds.
+     */
+    class Scheduler
+    {
+    public:
+
+        /**
+         * Create a scheduler without systems.
+         */
+        Scheduler()
+        : systems_{}
+        {
+
+        }
+
+        /**
+         * Add a system to the scheduler.
+         *
+         * @tparam Reads a type_list_t declaration of the components the system reads.
+         * @tparam Writes a type_list_t declaration of the components the system writes.
+         * @tparam Fn a callable with the signature fn(Registry&).
+         *
+         * @param fn the system.
+         *
+         * @returns the index of the system (the order in which it was added).
+         */
+        template <typename Reads, typename Writes = typing::type_list_t<>, typename Fn>
+        size_t add(Fn&& fn)
+        {
+            System system{};
+
+            system.run = std::forward<Fn>(fn);
+            system.prepare = &SystemHelper<typing::type_list_t<>>::template prepare<Reads, Writes>;
+            system.reads = SystemHelper<Reads>::ids();
+            system.writes = SystemHelper<Writes>::ids();
+
+            // the new system depends on every previous system it conflicts with.
+            for(size_t i = 0; i < systems_.size(); ++i)
+            {
+                if(conflict(systems_[i], system))
+                {
+                    systems_[i].dependents.push_back(systems_.size());
+                    ++system.dependencies;
+                }
+            }
+
+            systems_.push_back(std::move(system));
+
+            return systems_.size() - 1;
+        }
+
+        /**
+         * Get the number of systems of the scheduler.
+         */
+        inline size_t size() const noexcept
+        {
+            return systems_.size();
+        }
+
+        /**
+         * Check if a system has to wait for another one.
+         *
+         * @param before the index of the system that was added first.
+         * @param after the index of the system that was added later.
+         *
+         * @returns true if after directly depends on before, false otherwise.
+         */
+        bool depends(const size_t before, const size_t after) const
+        {
+            const std::vector<size_t>& dependents = systems_[before].dependents;
+
+            return std::find(dependents.begin(), dependents.end(), after) != dependents.end();
+        }
+
+        /**
+         * Run all the systems once. The call returns when every system
+         * finished, the calling thread helps running them.
+         *
+         * @param registry the registry the systems work on.
+         * @param pool the pool whose workers run the systems.
+         */
+        void run(Registry& registry, ThreadPool& pool)
+        {
+            ENTIS_PROFILE_SCOPE("entis::Scheduler::run");
+
+            // create the managers beforehand since they can't be created concurrently.
+            for(const System& system : systems_)
+                system.prepare(registry);
+
+            // the systems only read and write components (see Registry::freeze).
+            registry.freeze();
+
+            // thaw even if something throws.
+            struct ThawGuard
+            {
+                ~ThawGuard()
+                {
+                    registry.thaw();
+                }
+
+                Registry& registry;
+            } guard{registry};
+
+            std::unique_ptr<std::atomic<size_t>[]> dependencies{new std::atomic<size_t>[systems_.size()]};
+
+            for(size_t i = 0; i < systems_.size(); ++i)
+                dependencies[i].store(systems_[i].dependencies, std::memory_order_relaxed);
+
+            std::atomic<size_t> remaining{systems_.size()};
+
+            for(size_t i = 0; i < systems_.size(); ++i)
+            {
+                if(systems_[i].dependencies == 0)
+                    launch(i, registry, pool, dependencies.get(), remaining);
+            }
+
+            pool.wait(remaining);
+        }
+
+    private:
+
+        /**
+         * A system with its component accesses and dependencies.
+         */
+        struct System
+        {
+            std::function<void(Registry&)> run;
+            void (*prepare)(Registry&) = nullptr;
+            std::vector<id_t> reads;
+            std::vector<id_t> writes;
+            std::vector<size_t> dependents; // systems that wait for this one.
+            size_t dependencies = 0;        // systems this one waits for.
+        };
+
+        std::vector<System> systems_;
+
+        /**
+         * Check if two systems can't run at the same time.
+         */
+        static bool conflict(const System& a, const System& b)
+        {
+            return intersect(a.writes, b.writes) || intersect(a.writes, b.reads) || intersect(a.reads, b.writes);
+        }
+
+        static bool intersect(const std::vector<id_t>& a, const std::vector<id_t>& b)
+        {
+            return std::any_of(a.begin(), a.end(), [&b](const id_t type)
+            {
+                return std::find(b.begin(), b.end(), type) != b.end();
+            });
+        }
+
+        /**
+         * Submit a system to the pool, once it finishes the systems that
+         * were waiting only for it are submitted too.
+         */
+        void launch(const size_t index, Registry& registry, ThreadPool& pool,
+                    std::atomic<size_t>* dependencies, std::atomic<size_t>& remaining)
+        {
+            pool.submit([this, index, &registry, &pool, dependencies, &remaining]
+            {
+                systems_[index].run(registry);
+
+                for(const size_t dependent : systems_[index].dependents)
+                {
+                    if(dependencies[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                        launch(dependent, registry, pool, dependencies, remaining);
+                }
+
+                remaining.fetch_sub(1, std::memory_order_release);
+            });
+        }
+
+        /**
+         * Abstract class used to convert the type_list_t declarations of
+         * a system into runtime data.
+         *
+         * @tparam List a type_list_t definition.
+         */
+        template <typename List>
+        class SystemHelper;
+
+        /**
+         * Specialization used to convert a type_list_t into a parameter pack.
+         *
+         * @tparam List parameter pack containing the list of types specified on
+         * a type_list_t.
+         */
+        template <typename... List>
+        class SystemHelper<typing::type_list_t<List...>>
+        {
+        public:
+            /**
+             * Get the TypeIndex of every type on the list.
+             */
+            static std::vector<id_t> ids()
+            {
+                return std::vector<id_t>{ TypeIndex::get<List>()... };
+            }
+
+            /**
+             * Create the managers of the components on both lists.
+             */
+            template <typename Reads, typename Writes>
+            static void prepare(Registry& registry)
+            {
+                SystemHelper<Reads>::create(registry);
+                SystemHelper<Writes>::create(registry);
+            }
+
+            /**
+             * Create the managers of the components on the list.
+             */
+            static void create(Registry& registry)
+            {
+                (registry.storage<List>(), ...);
+            }
+        };
+    };
+}
+
+#endif
@@ -0,0 +1,252 @@
+#ifndef SHARDED_REGISTRY_H
+#define SHARDED_REGISTRY_H
+
+#include <memory>
+#include <vector>
+#include <cassert>
+#include <utility>
+#include <memory_resource>
+
+#include "types.h"
+#include "config.h"
+#include "registry.h"
+#include "thread_pool.h"
+
+namespace entis
+{
+    /**
+     * Splits the entities across several independent registries (shards)
+     * so a thread per shard can change its structure (make_entity, bind,
+     * unbind, kill_entity, etc.) without locks or command buffers, e.g. a
+     * shard per zone of a simulation.
+     *
+     * Each entity belongs to the shard it was created on for its whole
+     * life, its handle is the index of the shard plus its identifier on it.
+     * Two threads must never work on the same shard at the same time and an
+     * entity can't have components on other shards. Changes that span shards
+     * should be recorded on a CommandBuffer and flushed into the target shard
+     * by its owner.
+     */
+    class ShardedRegistry
+    {
+    public:
+
+        /**
+         * Handle to an entity of a sharded registry.
+         */
+        struct Entity
+        {
+            size_t shard; // index of the shard that owns the entity.
+            id_t id;      // identifier of the entity on its shard.
+        };
+
+        /**
+         * Create a sharded registry with empty shards.
+         *
+         * @param shards the number of shards (at least one).
+         * @param resource the memory resource the shards allocate from, it must
+         * outlive the registry and, since the shards grow concurrently, it must
+         * be thread-safe (e.g. the default one or a std::pmr::synchronized_pool_resource).
+         */
+        explicit ShardedRegistry(const size_t shards,
+                                 std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : shards_{}
+        {
+            assert(shards > 0 && "a sharded registry needs at least one shard");
+
+            shards_.reserve(shards);
+
+            for(size_t i = 0; i < shards; ++i)
+                shards_.push_back(std::make_unique<Registry>(resource));
+        }
+
+        /**
+         * Get the number of shards.
+         */
+        inline size_t size() const noexcept
+        {
+            return shards_.size();
+        }
+
+        /**
+         * Get a shard, to be used by a single thread at a time.
+         *
+         * @param index the index of the shard.
+         *
+         * @returns the registry of the shard.
+         */
+        inline Registry& shard(const size_t index) noexcept
+        {
+            return *shards_[index];
+        }
+
+        /**
+         * Get a shard.
+         *
+         * @param index the index of the shard.
+         *
+         * @returns the registry of the shard.
+         */
+        inline const Registry& shard(const size_t index) const noexcept
+        {
+            return *shards_[index];
+        }
+
+        /**
+         * Create a new entity on a shard.
+         *
+         * @param index the index of the shard that will own the entity.
+         *
+         * @returns the handle of the entity (its identifier is the null
+         * entity when every index of the shard is in use).
+         */
+        inline Entity make_entity(const size_t index)
+        {
+            return Entity{index, shards_[index]->make_entity()};
+        }
+
+        /**
+         * Check if an entity is alive.
+         *
+         * @param entity the handle of the entity.
+         */
+        inline bool is_alive(const Entity entity) const
+        {
+            return shards_[entity.shard]->is_alive(entity.id);
+        }
+
+        /**
+         * Kill an entity (see Registry::kill_entity).
+         *
+         * @param entity the handle of the entity to kill.
+         */
+        inline void kill_entity(const Entity entity)
+        {
+            shards_[entity.shard]->kill_entity(entity.id);
+        }
+
+        /**
+         * Bind a component T to an entity (see Registry::bind).
+         *
+         * @tparam T the type of the component we want to bind.
+         * @tparam ...Args a packed list of values that will be
+         * perfectly-forwarded to the constructor of T.
+         *
+         * @param entity the handle of the entity.
+         *
+         * @returns the result of binding the component on the shard.
+         */
+        template <typename T, typename... Args>
+        BindResult bind(const Entity entity, Args&&... args)
+        {
+            return shards_[entity.shard]->template bind<T>(entity.id, std::forward<Args>(args)...);
+        }
+
+        /**
+         * Delete the component T of an entity if any (see Registry::erase).
+         *
+         * @tparam T the type of the component.
+         *
+         * @param entity the handle of the entity.
+         *
+         * @returns true if the entity had a component T, false otherwise.
+         */
+        template <typename T>
+        bool erase(const Entity entity)
+        {
+            return shards_[entity.shard]->template erase<T>(entity.id);
+        }
+
+        /**
+         * Check if an entity has a component T.
+         *
+         * @tparam T the type of the component.
+         *
+         * @param entity the handle of the entity.
+         */
+        template <typename T>
+        bool has_component(const Entity entity) const
+        {
+            return shards_[entity.shard]->template has_component<T>(entity.id);
+        }
+
+        /**
+         * Get the component T of an entity (see Registry::get_component).
+         *
+         * @tparam T the type of the component.
+         *
+         * @param entity the handle of the entity.
+         */
+        template <typename T>
+        Component<T> get_component(const Entity entity) const
+        {
+            return static_cast<const Registry&>(*shards_[entity.shard]).template get_component<T>(entity.id);
+        }
+
+        /**
+         * Get the component T of an entity (see Registry::get_component).
+         *
+         * @tparam T the type of the component.
+         *
+         * @param entity the handle of the entity.
+         */
+        template <typename T>
+        MutableComponent<T> get_component(const Entity entity)
+        {
+            return shards_[entity.shard]->template get_component<T>(entity.id);
+        }
+
+        /**
+         * Run a function on every shard concurrently, a single task per
+         * shard, so it can change the structure of its shard freely. The
+         * calling thread helps running the tasks and returns once all of
+         * them are done.
+         *
+         * @tparam Fn a callable with the signature fn(Registry& shard, size_t index).
+         *
+         * @param pool the pool whose workers run the function.
+         * @param fn the function applied to every shard.
+         */
+        template <typename Fn>
+        void parallel(ThreadPool& pool, Fn&& fn)
+        {
+            pool.parallel_for(shards_.size(), 1, [this, &fn](const size_t begin, const size_t end)
+            {
+                for(size_t i = begin; i < end; ++i)
+                    fn(*shards_[i], i);
+            });
+        }
+
+        /**
+         * Apply a function to every entity that has the specified components
+         * (and none of the excluded ones) on all the shards, the shards are
+         * visited concurrently.
+         *
+         * @tparam Components the types of the components the entities must have.
+         * @tparam Excluded the types of the components the entities mustn't have.
+         * @tparam Fn a callable with the signature fn(Entity, Components&...)
+         * where tags are left out like on views.
+         *
+         * @param pool the pool whose workers visit the shards.
+         * @param fn the function applied to every entity.
+         */
+        template <typename... Components, typename... Excluded, typename Fn>
+        void each(ThreadPool& pool, Fn&& fn, exclude_t<Excluded...> excluded = {})
+        {
+            parallel(pool, [&fn, excluded](Registry& shard, const size_t index)
+            {
+                shard.template view<Components...>(excluded).each(
+                    [&fn, index](const id_t entity, auto&... components)
+                {
+                    fn(Entity{index, entity}, components...);
+                });
+            });
+        }
+
+    private:
+
+        std::vector<std::unique_ptr<Registry>> shards_; // stable addresses for the handles of the users.
+    };
+}
+
+#endif
@@ -0,0 +1,123 @@
+#ifndef SIGNAL_H
+#define SIGNAL_H
+
+#include <vector>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <functional>
+
+namespace entis
+{
+    /**
+     * Handle returned when connecting a listener to a signal, it is used
+     * to disconnect the listener later on.
+     */
+    struct Connection
+    {
+        size_t id;
+    };
+
+    /**
+     * A list of listeners that are called, in the order they were connected,
+     * every time the signal is published.
+     *
+     * Publishing a signal without listeners is a check of an empty vector.
+     * Listeners mustn't connect nor disconnect listeners of the signal that
+     * is calling them.
+     *
+     * @tparam Args the types of the parameters passed to the listeners.
+     */
+    template <typename... Args>
+    class Signal
+    {
+    public:
+
+        /**
+         * Create a signal without listeners.
+         */
+        Signal()
+        : listeners_{},
+          next_{0}
+        {
+
+        }
+
+        /**
+         * Connect a listener to the signal.
+         *
+         * @tparam Fn a callable with the signature fn(Args...).
+         *
+         * @param fn the listener.
+         *
+         * @returns the handle used to disconnect the listener.
+         */
+        template <typename Fn>
+        Connection connect(Fn&& fn)
+        {
+            const Connection connection{next_++};
+
+            listeners_.emplace_back(connection.id, std::forward<Fn>(fn));
+
+            return connection;
+        }
+
+        /**
+         * Disconnect a listener from the signal.
+         *
+         * @param connection the handle returned when the listener was connected.
+         *
+         * @returns true if the listener was connected, false otherwise.
+         */
+        bool disconnect(const Connection connection)
+        {
+            const auto it = std::find_if(listeners_.begin(), listeners_.end(), [connection](const Listener& listener)
+            {
+                return listener.first == connection.id;
+            });
+
+            if(it == listeners_.end())
+                return false;
+
+            listeners_.erase(it);
+
+            return true;
+        }
+
+        /**
+         * Check if the signal has no listeners.
+         */
+        inline bool empty() const noexcept
+        {
+            return listeners_.empty();
+        }
+
+        /**
+         * Get the number of listeners connected to the signal.
+         */
+        inline size_t size() const noexcept
+        {
+            return listeners_.size();
+        }
+
+        /**
+         * Call every listener with the specified arguments.
+         *
+         * @param args the arguments passed to the listeners.
+         */
+        void publish(Args... args) const
+        {
+            for(const Listener& listener : listeners_)
+                listener.second(args...);
+        }
+
+    private:
+
+        using Listener = std::pair<size_t, std::function<void(Args...)>>;
+
+        std::vector<Listener> listeners_;
+        size_t next_; // id of the next connection.
+    };
+}
+
+#endif
@@ -0,0 +1,230 @@
+#ifndef SIGNATURE_H
+#define SIGNATURE_H
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+#include "config.h"
+#include "type_index.h"
+
+namespace entis
+{
+    /**
+     * A fixed-width bitset with one bit per component type (indexed by its
+     * TypeIndex) used by the Registry to know which components an entity has.
+     *
+     * Testing whether an entity has a set of components (or none of them) is
+     * an AND and a compare per word instead of a lookup per component, the
+     * loops over the words have a fixed trip count thus, compilers unroll and
+     * vectorize them.
+     *
+     * Types whose TypeIndex doesn't fit (>= MAX_COMPONENTS) can't be
+     * represented, see representable.
+     */
+    class Signature
+    {
+    public:
+
+        /// Number of 64-bit words of a signature.
+        static constexpr size_t WORDS = MAX_COMPONENTS / 64;
+
+        /**
+         * Create an empty signature.
+         */
+        constexpr Signature() noexcept
+        : words_{}
+        {
+
+        }
+
+        /**
+         * Create the signature of the specified component types.
+         *
+         * @tparam Types the types of the components.
+         *
+         * @returns a signature with the bits of every type set.
+         */
+        template <typename... Types>
+        static Signature of() noexcept
+        {
+            Signature signature{};
+
+            (signature.set(TypeIndex::get<Types>()), ...);
+
+            return signature;
+        }
+
+        /**
+         * Check if every one of the specified component types can be
+         * represented by a signature.
+         *
+         * @tparam Types the types of the components.
+         */
+        template <typename... Types>
+        static bool representable() noexcept
+        {
+            return ((TypeIndex::get<Types>() < MAX_COMPONENTS) && ...);
+        }
+
+        /**
+         * Set the bit of a component type (ignored if it doesn't fit).
+         *
+         * @param type the TypeIndex of the component.
+         */
+        inline void set(const id_t type) noexcept
+        {
+            if(type < MAX_COMPONENTS)
+                words_[type / 64] |= uint64_t{1} << (type % 64);
+        }
+
+        /**
+         * Clear the bit of a component type (ignored if it doesn't fit).
+         *
+         * @param type the TypeIndex of the component.
+         */
+        inline void reset(const id_t type) noexcept
+        {
+            if(type < MAX_COMPONENTS)
+                words_[type / 64] &= ~(uint64_t{1} << (type % 64));
+        }
+
+        /**
+         * Check if the bit of a component type is set.
+         *
+         * @param type the TypeIndex of the component.
+         */
+        inline bool test(const id_t type) const noexcept
+        {
+            return type < MAX_COMPONENTS && (words_[type / 64] >> (type % 64)) & 1;
+        }
+
+        /**
+         * Clear every bit.
+         */
+        inline void clear() noexcept
+        {
+            words_ = {};
+        }
+
+        /**
+         * Check if no bit is set.
+         */
+        inline bool empty() const noexcept
+        {
+            uint64_t any = 0;
+
+            for(size_t i = 0; i < WORDS; ++i)
+                any |= words_[i];
+
+            return any == 0;
+        }
+
+        /**
+         * Check if every bit of a mask is set.
+         *
+         * @param mask the signature of the required components.
+         */
+        inline bool contains(const Signature& mask) const noexcept
+        {
+            uint64_t missing = 0;
+
+            for(size_t i = 0; i < WORDS; ++i)
+                missing |= mask.words_[i] & ~words_[i];
+
+            return missing == 0;
+        }
+
+        /**
+         * Check if any bit of a mask is set.
+         *
+         * @param mask the signature of the components.
+         */
+        inline bool intersects(const Signature& mask) const noexcept
+        {
+            uint64_t common = 0;
+
+            for(size_t i = 0; i < WORDS; ++i)
+                common |= mask.words_[i] & words_[i];
+
+            return common != 0;
+        }
+
+        /**
+         * Check if every bit of with is set and no bit of without is set.
+         *
+         * @param with the signature of the required components.
+         * @param without the signature of the excluded components.
+         */
+        inline bool matches(const Signature& with, const Signature& without) const noexcept
+        {
+            uint64_t mismatch = 0;
+
+            for(size_t i = 0; i < WORDS; ++i)
+                mismatch |= (with.words_[i] & ~words_[i]) | (without.words_[i] & words_[i]);
+
+            return mismatch == 0;
+        }
+
+        /**
+         * Call a function with the TypeIndex of every set bit (in increasing
+         * order), only the set bits are visited.
+         *
+         * @tparam Fn a callable with the signature fn(id_t).
+         *
+         * @param fn the function to call.
+         */
+        template <typename Fn>
+        void each(Fn&& fn) const
+        {
+            for(size_t i = 0; i < WORDS; ++i)
+            {
+                for(uint64_t word = words_[i]; word != 0; word &= word - 1)
+                    fn(static_cast<id_t>(i * 64 + lowest_bit(word)));
+            }
+        }
+
+        /**
+         * Get a word of the bitset (the bits of the types [64 * i, 64 * i + 63]).
+         *
+         * @param i the index of the word.
+         */
+        inline uint64_t word(const size_t i) const noexcept
+        {
+            return words_[i];
+        }
+
+        inline bool operator==(const Signature& other) const noexcept
+        {
+            return words_ == other.words_;
+        }
+
+        inline bool operator!=(const Signature& other) const noexcept
+        {
+            return words_ != other.words_;
+        }
+
+    private:
+
+        std::array<uint64_t, WORDS> words_;
+
+        /**
+         * Get the position of the lowest set bit of a non-zero word.
+         */
+        static inline size_t lowest_bit(const uint64_t word) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<size_t>(__builtin_ctzll(word));
+#else
+            size_t bit = 0;
+
+            while(((word >> bit) & 1) == 0)
+                ++bit;
+
+            return bit;
+#endif
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,625 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <optional>
+#include <type_traits>
+
+#include "error.h"
+#include "types.h"
+#include "config.h"
+#include "entity.h"
+#include "registry.h"
+#include "signature.h"
+
+namespace entis
+{
+    /**
+     * Appends binary blocks to a buffer of bytes. Every block is aligned
+     * (relative to the start of the buffer) to the alignment of its type,
+     * so a reader whose buffer is aligned as well (e.g. a memory-mapped
+     * file) can use the blocks in place.
+     *
+     * Values are written with the native layout and byte order.
+     */
+    class OutputArchive
+    {
+    public:
+
+        /**
+         * Create an archive that appends to a buffer.
+         *
+         * @param buffer the buffer the blocks are appended to.
+         */
+        explicit OutputArchive(std::vector<std::byte>& buffer)
+        : buffer_{buffer}
+        {
+
+        }
+
+        /**
+         * Append a single trivially copyable value.
+         *
+         * @param value the value to write.
+         */
+        template <typename T>
+        void write(const T& value)
+        {
+            write(&value, 1);
+        }
+
+        /**
+         * Append a block of trivially copyable values with a single copy.
+         *
+         * @param values the first value of the block.
+         * @param count the number of values.
+         */
+        template <typename T>
+        void write(const T* values, const size_t count)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable values can be written as bytes");
+
+            const size_t offset = aligned(buffer_.size(), alignof(T));
+
+            buffer_.resize(offset + count * sizeof(T));
+
+            if(count > 0)
+                std::memcpy(buffer_.data() + offset, values, count * sizeof(T));
+        }
+
+        /**
+         * Get the number of bytes of the buffer.
+         */
+        inline size_t size() const noexcept
+        {
+            return buffer_.size();
+        }
+
+        /**
+         * Round an offset up to a multiple of an alignment (a power of two).
+         */
+        static constexpr size_t aligned(const size_t offset, const size_t alignment) noexcept
+        {
+            return (offset + alignment - 1) & ~(alignment - 1);
+        }
+
+    private:
+
+        std::vector<std::byte>& buffer_;
+    };
+
+    /**
+     * Reads the blocks written by an OutputArchive from a buffer of bytes
+     * (e.g. a file loaded in memory or mapped with mmap), the buffer isn't
+     * copied and must be aligned to the largest alignment of its blocks.
+     *
+     * Reading past the end of the buffer fails and every read after that
+     * fails too.
+     */
+    class InputArchive
+    {
+    public:
+
+        /**
+         * Create an archive over a buffer.
+         *
+         * @param data the first byte of the buffer.
+         * @param size the number of bytes of the buffer.
+         */
+        InputArchive(const std::byte* data, const size_t size)
+        : data_{data},
+          size_{size},
+          position_{0},
+          failed_{false}
+        {
+
+        }
+
+        /**
+         * Read a single trivially copyable value.
+         *
+         * @param value where the value is stored.
+         *
+         * @returns true if the value was read, false if the buffer ended.
+         */
+        template <typename T>
+        bool read(T& value)
+        {
+            const T* source = block<T>(1);
+
+            if(source)
+                std::memcpy(&value, source, sizeof(T));
+
+            return source != nullptr;
+        }
+
+        /**
+         * Get a block of trivially copyable values without copying it.
+         *
+         * @param count the number of values of the block.
+         *
+         * @returns a pointer to the first value on the buffer or nullptr if
+         * the buffer ended.
+         */
+        template <typename T>
+        const T* block(const size_t count)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable values can be read as bytes");
+
+            const size_t offset = OutputArchive::aligned(position_, alignof(T));
+
+            if(failed_ || offset > size_ || count > (size_ - offset) / sizeof(T))
+            {
+                failed_ = true;
+
+                return nullptr;
+            }
+
+            assert(reinterpret_cast<std::uintptr_t>(data_ + offset) % alignof(T) == 0 && "the buffer isn't aligned");
+
+            position_ = offset + count * sizeof(T);
+
+            return reinterpret_cast<const T*>(data_ + offset);
+        }
+
+        /**
+         * Check if a read failed because the buffer ended.
+         */
+        inline bool failed() const noexcept
+        {
+            return failed_;
+        }
+
+        /**
+         * Get the number of bytes read so far.
+         */
+        inline size_t position() const noexcept
+        {
+            return position_;
+        }
+
+    private:
+
+        const std::byte* data_;
+        size_t size_;
+        size_t position_;
+        bool failed_;
+    };
+
+    namespace detail
+    {
+        /// Tag written at the beginning of the entities block ("ENTS").
+        inline constexpr uint32_t SNAPSHOT_MAGIC = 0x53544e45;
+
+        /// Version of the layout of the blocks.
+        inline constexpr uint32_t SNAPSHOT_VERSION = 1;
+    }
+
+    /**
+     * Writes the entities and the components of a registry to an archive
+     * as contiguous blocks: the table of entities (along with the list of
+     * dead ones, so recycling continues where it was) and, for each type,
+     * its packed keys followed by its values. Values that are trivially
+     * copyable and packed are written with a single copy.
+     *
+     * The entities must be written first, then the components in any order
+     * but the same order must be used for loading them (see SnapshotLoader):
+     *
+     * std::vector<std::byte> buffer{};
+     * entis::OutputArchive archive{buffer};
+     *
+     * entis::Snapshot{registry}.entities(archive).component<Position>(archive).component<Frozen>(archive);
+     */
+    class Snapshot
+    {
+    public:
+
+        /**
+         * Create a snapshot of a registry.
+         *
+         * @param registry the registry to write, it mustn't change meanwhile.
+         */
+        explicit Snapshot(const Registry& registry)
+        : registry_{registry}
+        {
+
+        }
+
+        /**
+         * Write the table of entities.
+         *
+         * @param archive the archive the block is appended to.
+         *
+         * @returns the snapshot itself so calls can be chained.
+         */
+        const Snapshot& entities(OutputArchive& archive) const
+        {
+            archive.write(detail::SNAPSHOT_MAGIC);
+            archive.write(detail::SNAPSHOT_VERSION);
+            archive.write(static_cast<uint64_t>(registry_.entities_.size()));
+            archive.write(registry_.current_);
+            archive.write(registry_.entities_.data(), registry_.entities_.size());
+
+            return *this;
+        }
+
+        /**
+         * Write the components T, they must be trivially copyable (see the
+         * overload with a serialization function otherwise).
+         *
+         * @tparam T the type of the components.
+         *
+         * @param archive the archive the block is appended to.
+         *
+         * @returns the snapshot itself so calls can be chained.
+         */
+        template <typename T>
+        const Snapshot& component(OutputArchive& archive) const
+        {
+            static_assert(is_tag_v<T> || std::is_trivially_copyable_v<T>,
+                          "components that aren't trivially copyable need a serialization function");
+
+            if constexpr(is_tag_v<T> || is_soa_v<T> || Storage<T>::in_place_delete)
+            {
+                return component<T>(archive, &Snapshot::write<T>);
+            }
+            else
+            {
+                // packed keys and values are written with a copy each.
+                const ComponentManager<T> manager = registry_.get_component_manager<T>();
+
+                const size_t count = manager ? manager->size() : 0;
+
+                archive.write(static_cast<uint64_t>(count));
+                archive.write(count ? manager->keys().data() : nullptr, count);
+                archive.write(count ? manager->data() : nullptr, count);
+
+                return *this;
+            }
+        }
+
+        /**
+         * Write the components T with a serialization function.
+         *
+         * @tparam T the type of the components.
+         * @tparam Fn a callable with the signature fn(OutputArchive&, const T&)
+         * (it isn't called for tags).
+         *
+         * @param archive the archive the block is appended to.
+         * @param fn the function that writes a single component.
+         *
+         * @returns the snapshot itself so calls can be chained.
+         */
+        template <typename T, typename Fn>
+        const Snapshot& component(OutputArchive& archive, Fn&& fn) const
+        {
+            const ComponentManager<T> manager = registry_.get_component_manager<T>();
+
+            std::vector<id_t> keys{};
+
+            if(manager)
+            {
+                keys.reserve(manager->size());
+
+                // paged managers leave holes (MAX_ID) on their packed keys.
+                for(const id_t key : manager->keys())
+                {
+                    if(key != MAX_ID)
+                        keys.push_back(key);
+                }
+            }
+
+            archive.write(static_cast<uint64_t>(keys.size()));
+            archive.write(keys.data(), keys.size());
+
+            if constexpr(!is_tag_v<T>)
+            {
+                for(const id_t key : keys)
+                    fn(archive, manager->get(key));
+            }
+
+            return *this;
+        }
+
+    private:
+
+        const Registry& registry_;
+
+        /**
+         * Write a single trivially copyable component.
+         */
+        template <typename T>
+        static void write(OutputArchive& archive, const T& value)
+        {
+            archive.write(value);
+        }
+    };
+
+    /**
+     * Loads the blocks written by a Snapshot into an empty registry, in
+     * the same order they were written:
+     *
+     * entis::InputArchive archive{buffer.data(), buffer.size()};
+     * entis::SnapshotLoader loader{registry};
+     *
+     * loader.entities(archive);
+     * loader.component<Position>(archive);
+     * loader.component<Frozen>(archive);
+     *
+     * Packed trivially copyable components are copied in bulk from the
+     * archive. The registry bookkeeping (signatures, groups, cached queries
+     * and on_construct signals) is updated as if the components were bound.
+     */
+    class SnapshotLoader
+    {
+    public:
+
+        /**
+         * Create a loader for a registry.
+         *
+         * @param registry the registry the snapshot is loaded into.
+         */
+        explicit SnapshotLoader(Registry& registry)
+        : registry_{registry}
+        {
+
+        }
+
+        /**
+         * Load the table of entities, the registry must have no entities.
+         *
+         * @param archive the archive to read from.
+         *
+         * @returns an empty optional when the table was loaded and the
+         * corresponding LoadError otherwise.
+         */
+        std::optional<error::LoadError> entities(InputArchive& archive)
+        {
+            if(!registry_.entities_.empty())
+                return error::LoadError::NOT_EMPTY;
+
+            uint32_t magic = 0;
+            uint32_t version = 0;
+            uint64_t count = 0;
+            id_t current = NULL_INDEX;
+
+            if(!archive.read(magic) || !archive.read(version))
+                return error::LoadError::TRUNCATED;
+
+            if(magic != detail::SNAPSHOT_MAGIC || version != detail::SNAPSHOT_VERSION)
+                return error::LoadError::BAD_FORMAT;
+
+            if(!archive.read(count) || !archive.read(current))
+                return error::LoadError::TRUNCATED;
+
+            if(count > NULL_INDEX || (current != NULL_INDEX && current >= count))
+                return error::LoadError::BAD_FORMAT;
+
+            const id_t* entities = archive.block<id_t>(static_cast<size_t>(count));
+
+            if(!entities)
+                return error::LoadError::TRUNCATED;
+
+            if(!valid_entities(entities, static_cast<size_t>(count), current))
+                return error::LoadError::BAD_FORMAT;
+
+            registry_.entities_.assign(entities, entities + count);
+            registry_.signatures_.assign(static_cast<size_t>(count), Signature{});
+            registry_.current_ = current;
+
+            return std::optional<error::LoadError>{};
+        }
+
+        /**
+         * Load the components T, they must be trivially copyable (see the
+         * overload with a deserialization function otherwise).
+         *
+         * @tparam T the type of the components.
+         *
+         * @param archive the archive to read from.
+         *
+         * @returns an empty optional when the components were loaded and the
+         * corresponding LoadError otherwise.
+         */
+        template <typename T>
+        std::optional<error::LoadError> component(InputArchive& archive)
+        {
+            static_assert(is_tag_v<T> || std::is_trivially_copyable_v<T>,
+                          "components that aren't trivially copyable need a deserialization function");
+
+            const ComponentManager<T> manager = registry_.storage<T>();
+
+            const id_t* keys = nullptr;
+            size_t count = 0;
+
+            if(const std::optional<error::LoadError> error = read_keys(archive, manager, keys, count))
+                return error;
+
+            if constexpr(is_tag_v<T>)
+            {
+                manager->bind_range(keys, keys + count);
+            }
+            else
+            {
+                const T* values = archive.block<T>(count);
+
+                if(!values)
+                    return error::LoadError::TRUNCATED;
+
+                if constexpr(is_soa_v<T>)
+                {
+                    manager->reserve(count);
+
+                    for(size_t i = 0; i < count; ++i)
+                        manager->bind(keys[i], values[i]);
+                }
+                else
+                {
+                    manager->assign(keys, keys + count, values);
+                }
+            }
+
+            bound<T>(keys, count);
+
+            return std::optional<error::LoadError>{};
+        }
+
+        /**
+         * Load the components T with a deserialization function.
+         *
+         * @tparam T the type of the components.
+         * @tparam Fn a callable with the signature fn(InputArchive&) that
+         * returns a T (it isn't called for tags).
+         *
+         * @param archive the archive to read from.
+         * @param fn the function that reads a single component.
+         *
+         * @returns an empty optional when the components were loaded and the
+         * corresponding LoadError otherwise.
+         */
+        template <typename T, typename Fn>
+        std::optional<error::LoadError> component(InputArchive& archive, Fn&& fn)
+        {
+            const ComponentManager<T> manager = registry_.storage<T>();
+
+            const id_t* keys = nullptr;
+            size_t count = 0;
+
+            if(const std::optional<error::LoadError> error = read_keys(archive, manager, keys, count))
+                return error;
+
+            manager->reserve(count);
+
+            for(size_t i = 0; i < count; ++i)
+            {
+                if constexpr(is_tag_v<T>)
+                {
+                    manager->bind(keys[i]);
+                }
+                else
+                {
+                    T value = fn(archive);
+
+                    if(archive.failed())
+                    {
+                        bound<T>(keys, i);
+
+                        return error::LoadError::TRUNCATED;
+                    }
+
+                    manager->bind(keys[i], std::move(value));
+                }
+            }
+
+            bound<T>(keys, count);
+
+            return std::optional<error::LoadError>{};
+        }
+
+    private:
+
+        Registry& registry_;
+
+        /**
+         * Check that a table of entities is consistent: alive slots hold their
+         * own index, dead slots link to another slot (or end the list) and the
+         * list of dead entities starting at current visits every dead slot
+         * once, so recycling never reads out of bounds nor loops.
+         */
+        static bool valid_entities(const id_t* entities, const size_t count, const id_t current)
+        {
+            size_t dead = 0;
+
+            for(size_t i = 0; i < count; ++i)
+            {
+                const id_t link = to_index(entities[i]);
+
+                if(link == i)
+                    continue;
+
+                if(link != NULL_INDEX && link >= count)
+                    return false;
+
+                ++dead;
+            }
+
+            std::vector<bool> visited(count, false);
+            size_t length = 0;
+
+            for(id_t index = current; index != NULL_INDEX; index = to_index(entities[index]))
+            {
+                // alive slots link to themselves thus, they are caught here too.
+                if(visited[index])
+                    return false;
+
+                visited[index] = true;
+                ++length;
+            }
+
+            return length == dead;
+        }
+
+        /**
+         * Read the packed keys of a block and check that they belong to
+         * alive entities, that they aren't repeated and that the manager
+         * is empty.
+         */
+        template <typename Manager>
+        std::optional<error::LoadError> read_keys(InputArchive& archive, const Manager* manager,
+                                                  const id_t*& keys, size_t& count)
+        {
+            uint64_t size = 0;
+
+            if(!archive.read(size))
+                return error::LoadError::TRUNCATED;
+
+            if(manager->size() != 0)
+                return error::LoadError::NOT_EMPTY;
+
+            if(size > registry_.entities_.size())
+                return error::LoadError::BAD_FORMAT;
+
+            count = static_cast<size_t>(size);
+            keys = archive.block<id_t>(count);
+
+            if(!keys)
+                return error::LoadError::TRUNCATED;
+
+            std::vector<bool> seen(registry_.entities_.size(), false);
+
+            for(size_t i = 0; i < count; ++i)
+            {
+                if(!registry_.is_alive(keys[i]) || seen[to_index(keys[i])])
+                    return error::LoadError::BAD_FORMAT;
+
+                seen[to_index(keys[i])] = true;
+            }
+
+            return std::optional<error::LoadError>{};
+        }
+
+        /**
+         * Update the registry bookkeeping for the loaded components.
+         */
+        template <typename T>
+        void bound(const id_t* keys, const size_t count)
+        {
+            const Registry::ComponentHooks* hooks = registry_.find_hooks<T>();
+
+            for(size_t i = 0; i < count; ++i)
+            {
+                registry_.on_bound<T>(keys[i]);
+
+                if(hooks)
+                    hooks->construct.publish(registry_, keys[i]);
+            }
+        }
+    };
+}
+
+#endif
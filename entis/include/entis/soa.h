@@ -0,0 +1,612 @@
+#ifndef SOA_H
+#define SOA_H
+
+#include <new>
+#include <tuple>
+#include <vector>
+#include <cstddef>
+#include <utility>
+#include <optional>
+#include <type_traits>
+#include <memory_resource>
+
+#include "error.h"
+#include "config.h"
+#include "basic_sparse_set.h"
+
+namespace entis
+{
+    /**
+     * Declares a component T as structure-of-arrays: every listed field is
+     * stored on its own array instead of storing whole T objects. Specialize
+     * it with the pointers to the members of T:
+     *
+     * template <>
+     * struct entis::soa_traits<Particle>
+     * {
+     *     static constexpr auto fields = std::make_tuple(&Particle::x, &Particle::y, &Particle::life);
+     * };
+     *
+     * T must be default constructible, members that aren't listed are
+     * value-initialized when T is rebuilt from its fields.
+     *
+     * @tparam T the type of the component.
+     */
+    template <typename T>
+    struct soa_traits
+    {
+    };
+
+    /**
+     * Check if a component T is stored as structure-of-arrays (soa_traits<T>
+     * declares its fields).
+     *
+     * @tparam T the type of the component.
+     */
+    template <typename T, typename = void>
+    struct is_soa : std::false_type
+    {
+    };
+
+    template <typename T>
+    struct is_soa<T, std::void_t<decltype(soa_traits<T>::fields)>> : std::true_type
+    {
+    };
+
+    template <typename T>
+    inline constexpr bool is_soa_v = is_soa<T>::value;
+
+    /**
+     * Allocator that aligns its memory to Align bytes, used by the field
+     * arrays of a SoASet so they can be streamed with aligned SIMD loads.
+     * The memory comes from a memory resource (the default one unless
+     * specified).
+     *
+     * @tparam T the type of the values.
+     * @tparam Align the alignment in bytes (a power of two).
+     */
+    template <typename T, size_t Align>
+    struct AlignedAllocator
+    {
+        using value_type = T;
+
+        template <typename U>
+        struct rebind
+        {
+            using other = AlignedAllocator<U, Align>;
+        };
+
+        AlignedAllocator(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) noexcept
+        : resource_{resource}
+        {
+
+        }
+
+        template <typename U>
+        AlignedAllocator(const AlignedAllocator<U, Align>& other) noexcept
+        : resource_{other.resource()}
+        {
+
+        }
+
+        T* allocate(const size_t count)
+        {
+            return static_cast<T*>(resource_->allocate(count * sizeof(T), Align));
+        }
+
+        void deallocate(T* pointer, const size_t count) noexcept
+        {
+            resource_->deallocate(pointer, count * sizeof(T), Align);
+        }
+
+        inline std::pmr::memory_resource* resource() const noexcept
+        {
+            return resource_;
+        }
+
+        template <typename U>
+        bool operator==(const AlignedAllocator<U, Align>& other) const noexcept
+        {
+            return resource_ == other.resource() || resource_->is_equal(*other.resource());
+        }
+
+        template <typename U>
+        bool operator!=(const AlignedAllocator<U, Align>& other) const noexcept
+        {
+            return !(*this == other);
+        }
+
+    private:
+
+        std::pmr::memory_resource* resource_;
+    };
+
+    /**
+     * A non-owning range over the values of a field of a SoASet, the i-th
+     * value belongs to the i-th key of the set. data() is aligned to
+     * SOA_ALIGNMENT bytes.
+     *
+     * @tparam F the type of the field.
+     */
+    template <typename F>
+    class FieldSpan
+    {
+    public:
+
+        FieldSpan(F* data, const size_t size) noexcept
+        : data_{data},
+          size_{size}
+        {
+
+        }
+
+        inline F* data() const noexcept
+        {
+            return data_;
+        }
+
+        inline size_t size() const noexcept
+        {
+            return size_;
+        }
+
+        inline F* begin() const noexcept
+        {
+            return data_;
+        }
+
+        inline F* end() const noexcept
+        {
+            return data_ + size_;
+        }
+
+        inline F& operator[](const size_t index) const noexcept
+        {
+            return data_[index];
+        }
+
+    private:
+
+        F* data_;
+        size_t size_;
+    };
+
+    namespace detail
+    {
+        /**
+         * Get the type of the member a pointer to member refers to.
+         */
+        template <typename Member>
+        struct member_type;
+
+        template <typename C, typename F>
+        struct member_type<F C::*>
+        {
+            using type = F;
+        };
+
+        /**
+         * The field arrays of a SoA component.
+         */
+        template <typename Fields>
+        struct soa_columns;
+
+        template <typename... Members>
+        struct soa_columns<std::tuple<Members...>>
+        {
+            static_assert(((!std::is_same_v<typename member_type<Members>::type, bool>) && ...),
+                          "bool fields aren't supported (std::vector<bool> isn't contiguous)");
+
+            using type = std::tuple<std::vector<typename member_type<Members>::type,
+                                                AlignedAllocator<typename member_type<Members>::type, SOA_ALIGNMENT>>...>;
+        };
+    }
+
+    /**
+     * A sparse set that stores the fields of a component T (declared on
+     * soa_traits<T>) on separate aligned arrays, the i-th value of every
+     * array belongs to the i-th key.
+     *
+     * Systems that only read a few fields stream over those arrays (see
+     * field<I>()) instead of loading whole components, which also allows the
+     * compiler to vectorize the loops. Since there are no T objects, getting
+     * a component yields a copy rebuilt from its fields.
+     *
+     * @tparam T the type of the component.
+     */
+    template <typename T>
+    class SoASet : public BasicSparseSet
+    {
+        static_assert(std::is_default_constructible_v<T>, "a SoA component must be default constructible");
+
+        using Fields = std::decay_t<decltype(soa_traits<T>::fields)>;
+        using Columns = typename detail::soa_columns<Fields>::type;
+
+    public:
+
+        /// SoA components are always packed.
+        static constexpr bool in_place_delete = false;
+
+        /// Number of fields (arrays) of the component.
+        static constexpr size_t field_count = std::tuple_size_v<Fields>;
+
+        /**
+         * Create an empty set.
+         * 
+         * @param resource the memory resource the arrays are allocated from, it
+         * must outlive the set.
+         */
+        explicit SoASet(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : BasicSparseSet{resource},
+          columns_{make_columns(resource, std::make_index_sequence<field_count>{})}
+        {
+
+        }
+
+        /**
+         * Get the number of keys that have a value associated to them.
+         */
+        inline size_t size() const noexcept
+        {
+            return dense_.size();
+        }
+
+        /**
+         * Get the values of the I-th field (in the order of soa_traits<T>::fields).
+         *
+         * @tparam I the index of the field.
+         *
+         * @returns a span over the field of every key.
+         */
+        template <size_t I>
+        inline auto field() noexcept
+        {
+            auto& column = std::get<I>(columns_);
+
+            return FieldSpan<typename std::decay_t<decltype(column)>::value_type>{column.data(), column.size()};
+        }
+
+        /**
+         * Get the values of the I-th field (in the order of soa_traits<T>::fields).
+         *
+         * @tparam I the index of the field.
+         *
+         * @returns a span over the field of every key.
+         */
+        template <size_t I>
+        inline auto field() const noexcept
+        {
+            const auto& column = std::get<I>(columns_);
+
+            return FieldSpan<const typename std::decay_t<decltype(column)>::value_type>{column.data(), column.size()};
+        }
+
+        /**
+         * Get the I-th field of the value associated to a key without checking
+         * if the association exists.
+         *
+         * @tparam I the index of the field.
+         *
+         * @param key a key that has data associated to it.
+         *
+         * @returns a reference to the field.
+         */
+        template <size_t I>
+        inline auto& field(const id_t key) noexcept
+        {
+            return std::get<I>(columns_)[sparse_ref(key)];
+        }
+
+        /**
+         * Get the I-th field of the value associated to a key without checking
+         * if the association exists.
+         *
+         * @tparam I the index of the field.
+         *
+         * @param key a key that has data associated to it.
+         *
+         * @returns a const reference to the field.
+         */
+        template <size_t I>
+        inline const auto& field(const id_t key) const noexcept
+        {
+            return std::get<I>(columns_)[sparse_ref(key)];
+        }
+
+        /**
+         * Rebuild the value associated to a key from its fields without
+         * checking if the association exists.
+         *
+         * @param key a key that has data associated to it.
+         *
+         * @returns a copy of the value.
+         */
+        inline T get(const id_t key) const
+        {
+            return gather(sparse_ref(key), std::make_index_sequence<field_count>{});
+        }
+
+        /**
+         * Rebuild the value associated to a key from its fields if any.
+         *
+         * @param key the key whose value we want.
+         *
+         * @returns an optional with a copy of the value when the key has
+         * data associated with it and an empty optional otherwise.
+         */
+        std::optional<T> get_data(const id_t key) const
+        {
+            std::optional<T> result{};
+
+            if(has_data(key))
+                result = get(key);
+
+            return result;
+        }
+
+        /**
+         * Associate a key with a new value if it doesn't have a value
+         * associated with it already, update its fields otherwise.
+         *
+         * @tparam ...Args a single T or the values used to create one.
+         *
+         * @param key the key that will be associated to the value.
+         *
+         * @returns an optional with a BindError::INVALID_KEY when the key is
+         * the null key (MAX_ID) and an empty optional otherwise.
+         */
+        template <typename... Args>
+        std::optional<error::BindError> bind(const id_t key, Args&&... args)
+        {
+            if(is_null_key(key))
+                return std::optional<error::BindError>{ error::BindError::INVALID_KEY };
+
+            if constexpr(sizeof...(Args) == 1 && (std::is_same_v<std::decay_t<Args>, T> && ...))
+            {
+                (assign(key, std::forward<Args>(args)), ...);
+            }
+            else if constexpr(std::is_constructible_v<T, Args&&...>)
+            {
+                assign(key, T(std::forward<Args>(args)...));
+            }
+            else
+            {
+                assign(key, T{std::forward<Args>(args)...});
+            }
+
+            return std::optional<error::BindError>{};
+        }
+
+        /**
+         * Modify the value associated to a key if any. The value is rebuilt
+         * from its fields, passed to fn and written back (prefer field(key)
+         * to modify a single field).
+         *
+         * @tparam Fn a callable with the signature fn(T&).
+         *
+         * @param key the key whose value we want to modify.
+         * @param fn the function applied to the value.
+         *
+         * @returns true if the key has a value associated to it, false otherwise.
+         */
+        template <typename Fn>
+        bool patch(const id_t key, Fn&& fn)
+        {
+            if(!has_data(key))
+                return false;
+
+            const id_t index = sparse_ref(key);
+
+            T value = gather(index, std::make_index_sequence<field_count>{});
+
+            std::forward<Fn>(fn)(value);
+
+            scatter(index, std::move(value), std::make_index_sequence<field_count>{});
+
+            return true;
+        }
+
+        /**
+         * Allocate enough space on every field array to hold the specified
+         * number of values without growing.
+         *
+         * @param capacity the number of values.
+         */
+        void reserve(const size_t capacity)
+        {
+            dense_.reserve(capacity);
+
+            std::apply([capacity](auto&... columns){ (columns.reserve(capacity), ...); }, columns_);
+        }
+
+        /**
+         * Get the number of values the arrays can hold without growing.
+         */
+        inline size_t capacity() const noexcept
+        {
+            return dense_.capacity();
+        }
+
+        /**
+         * Release the unused pages of the sparse array and the excess capacity
+         * of the packed arrays and the field arrays.
+         */
+        virtual void shrink_to_fit() override
+        {
+            BasicSparseSet::shrink_to_fit();
+
+            std::apply([](auto&... columns){ (columns.shrink_to_fit(), ...); }, columns_);
+        }
+
+        /**
+         * Get the memory and occupancy of the arrays of the set.
+         * 
+         * @returns the statistics of the set (its type is left as MAX_ID).
+         */
+        virtual PoolStats stats() const noexcept override
+        {
+            PoolStats stats = BasicSparseSet::stats();
+
+            std::apply([&stats](const auto&... columns)
+            {
+                ((stats.bytes += columns.capacity() * sizeof(typename std::decay_t<decltype(columns)>::value_type)), ...);
+            }, columns_);
+
+            return stats;
+        }
+
+        /**
+         * Delete the association between a key and its value if any.
+         *
+         * @param key the key whose association we want to delete.
+         *
+         * @returns an optional with the value (rebuilt from its fields) that
+         * used to be associated with the key, an empty optional otherwise.
+         */
+        std::optional<T> unbind(const id_t key)
+        {
+            std::optional<T> result{};
+
+            if(has_data(key))
+            {
+                result = get(key);
+
+                remove(key);
+            }
+
+            return result;
+        }
+
+        /**
+         * Delete the association between a key and its value if any
+         * without passing the value to the caller (cheaper than unbind
+         * when the value isn't needed).
+         *
+         * @param key the key whose association we want to delete.
+         *
+         * @returns true if the key had a value associated to it, false otherwise.
+         */
+        bool erase(const id_t key)
+        {
+            if(!has_data(key))
+                return false;
+
+            remove(key);
+
+            return true;
+        }
+
+        /**
+         * Delete the association between an entity and its component
+         * if any.
+         *
+         * @param entity the entity whose association we want to delete.
+         */
+        virtual void delete_component(const id_t entity) override
+        {
+            erase(entity);
+        }
+
+    private:
+
+        Columns columns_;
+
+        /**
+         * Create the (empty) field arrays with allocators over a memory resource.
+         */
+        template <size_t... I>
+        static Columns make_columns(std::pmr::memory_resource* resource, std::index_sequence<I...>)
+        {
+            return Columns{ std::tuple_element_t<I, Columns>(
+                typename std::tuple_element_t<I, Columns>::allocator_type{resource})... };
+        }
+
+        /**
+         * Create or update the value associated to a key.
+         */
+        template <typename Value>
+        void assign(const id_t key, Value&& value)
+        {
+            if(out_of_bounds(key))
+                allocate_page(key);
+
+            const id_t index = sparse_index(key);
+
+            if(is_null_key(index))
+            {
+                sparse_ref(key) = dense_.size();
+                dense_.push_back(key);
+
+                push(std::forward<Value>(value), std::make_index_sequence<field_count>{});
+            }
+            else
+            {
+                dense_[index] = key;
+
+                scatter(index, std::forward<Value>(value), std::make_index_sequence<field_count>{});
+            }
+        }
+
+        /**
+         * Append the fields of a value to the arrays.
+         */
+        template <typename Value, size_t... I>
+        inline void push(Value&& value, std::index_sequence<I...>)
+        {
+            (std::get<I>(columns_).push_back(std::forward<Value>(value).*std::get<I>(soa_traits<T>::fields)), ...);
+        }
+
+        /**
+         * Overwrite the fields at a position of the arrays.
+         */
+        template <typename Value, size_t... I>
+        inline void scatter(const size_t index, Value&& value, std::index_sequence<I...>)
+        {
+            ((std::get<I>(columns_)[index] = std::forward<Value>(value).*std::get<I>(soa_traits<T>::fields)), ...);
+        }
+
+        /**
+         * Rebuild a value from the fields at a position of the arrays.
+         */
+        template <size_t... I>
+        inline T gather(const size_t index, std::index_sequence<I...>) const
+        {
+            T value{};
+
+            ((value.*std::get<I>(soa_traits<T>::fields) = std::get<I>(columns_)[index]), ...);
+
+            return value;
+        }
+
+        /**
+         * Delete the association of a key, the last value of every array
+         * fills the hole.
+         *
+         * @param key a key that has data associated to it.
+         */
+        void remove(const id_t key)
+        {
+            const id_t packed_index = sparse_ref(key);
+            const id_t last = dense_.back();
+
+            sparse_ref(key) = MAX_ID;
+
+            if(last != key)
+            {
+                sparse_ref(last) = packed_index;
+                dense_[packed_index] = last;
+
+                std::apply([packed_index](auto&... columns)
+                {
+                    ((columns[packed_index] = std::move(columns.back())), ...);
+                }, columns_);
+            }
+
+            dense_.pop_back();
+
+            std::apply([](auto&... columns){ (columns.pop_back(), ...); }, columns_);
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef SORT_H
+#define SORT_H
+
+#include <utility>
+#include <iterator>
+#include <algorithm>
+
+namespace entis
+{
+    /**
+     * Sorting algorithm that uses std::sort, the best choice when the
+     * elements are in random order.
+     */
+    struct StdSort
+    {
+        template <typename It, typename Compare>
+        void operator()(It first, It last, Compare compare) const
+        {
+            std::sort(first, last, std::move(compare));
+        }
+    };
+
+    /**
+     * Insertion sort, linear when the elements are nearly sorted (e.g.
+     * re-sorting by depth every frame, where only a few elements move).
+     * The sort is stable.
+     */
+    struct InsertionSort
+    {
+        template <typename It, typename Compare>
+        void operator()(It first, It last, Compare compare) const
+        {
+            if(first == last)
+                return;
+
+            for(It current = std::next(first); current != last; ++current)
+            {
+                auto value = std::move(*current);
+
+                It hole = current;
+
+                // shift the greater elements one position to the right.
+                for(; hole != first && compare(value, *std::prev(hole)); --hole)
+                    *hole = std::move(*std::prev(hole));
+
+                *hole = std::move(value);
+            }
+        }
+    };
+}
+
+#endif
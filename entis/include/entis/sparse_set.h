@@ -1,17 +1,25 @@
 #ifndef SPARSE_SET_H
 #define SPARSE_SET_H
 
+#include <new>
+#include <cassert>
+#include <memory>
 #include <vector>
 #include <utility>
+#include <iterator>
 #include <optional>
+#include <numeric>
 #include <algorithm>
 #include <functional>
 #include <type_traits>
-#include <unordered_map>
+#include <memory_resource>
 
 #include "config.h"
 #include "error.h"
-#include "component_manager.h"
+#include "sort.h"
+#include "entity.h"
+#include "storage.h"
+#include "basic_sparse_set.h"
 
 
 namespace entis
@@ -26,64 +34,371 @@ namespace entis
      * elements of type T in contiguous memory so we can take advange of
      * the CPU cache at the cost of having a sparse array for the keys.
      * 
+     * Keys are entities thus, the sparse array is indexed with the index
+     * of the key (to_index) while the packed array stores the whole key so
+     * two versions of the same index are told apart.
+     * 
+     * The layout of the values is chosen with storage_traits<T>: by default
+     * they are packed on a std::vector while components that declare 
+     * in_place_delete are kept on pages so their addresses are stable, in that
+     * case unbinding leaves a hole (a MAX_ID tombstone on the packed array of
+     * keys) that is reused by the next bind and removed by compact.
+     * 
      * @tparam T the type of the data that the container will store.
      */
     template <typename T>
-    class SparseSet : public IComponentManager
+    class SparseSet : public BasicSparseSet
     {
     public:
 
+        /// Whether values keep their address until they are unbound (see storage_traits).
+        static constexpr bool in_place_delete = storage_traits<T>::in_place_delete;
+
         /**
          * Create an empty sparse set that will store 
          * values of type T.
          * 
          * @tparam T the type of the data that the container will store.
+         * 
+         * @param resource the memory resource the arrays are allocated from, it
+         * must outlive the set. Allocator-aware values (e.g. std::pmr::string) 
+         * stored on the packed layout get it too.
          */
-        SparseSet()
-        : sparse_{},
-          dense_{},
-          data_{}
+        explicit SparseSet(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : BasicSparseSet{resource},
+          data_{resource},
+          holes_{resource}
         { 
 
         }
 
         /**
-         * Check if the key has any data assiciated to it.
+         * Destroy the values (the paged layout doesn't track them by itself).
+         */
+        ~SparseSet()
+        {
+            if constexpr(in_place_delete && !std::is_trivially_destructible_v<T>)
+            {
+                for(size_t i = 0; i < dense_.size(); ++i)
+                {
+                    if(!is_null_key(dense_[i]))
+                        data_.destroy(i);
+                }
+            }
+        }
+
+        /**
+         * Get the value associated to the supplied key if any.
          * 
-         * @param key the key that we want to test.
+         * @param key the key whose value we want to retrieve.
          * 
-         * @returns true if it has any value associated to it,
-         * false otherwise.
+         * @returns an optional with a reference_wrapper (const T&) to 
+         * the type T when the key has data associated with it and an 
+         * empty optional otherwise. 
          */
-        inline bool has_data(const id_t key) noexcept
+        std::optional<std::reference_wrapper<const T>> get_data(const id_t key) const
         {
-            bool result = true;
+            std::optional<std::reference_wrapper<const T>> result{};
 
-            if(out_of_bounds(key) || is_null_key(sparse_[key]))
-                result = false;
+            if(const id_t position = index(key); !is_null_key(position))
+                result = std::cref(data_[position]);
 
             return result;
         }
 
         /**
-         * Get the value associated to the supplied key if any.
+         * Get the value associated to the supplied key if any so it
+         * can be modified in place.
          * 
          * @param key the key whose value we want to retrieve.
          * 
-         * @returns an optional with a reference_wrapper (const T&) to 
-         * the type T when the key has data associated with it and an 
+         * @returns an optional with a reference_wrapper (T&) to the 
+         * type T when the key has data associated with it and an 
          * empty optional otherwise. 
          */
-        std::optional<std::reference_wrapper<const T>> get_data(const id_t key)
+        std::optional<std::reference_wrapper<T>> get_data(const id_t key)
         {
-            std::optional<std::reference_wrapper<const T>> result{};
+            std::optional<std::reference_wrapper<T>> result{};
 
-            if(has_data(key))
-                result = std::cref(data_[sparse_[key]]);
+            if(const id_t position = index(key); !is_null_key(position))
+                result = std::ref(data_[position]);
 
             return result;
         }
 
+        /**
+         * Get the value associated to the supplied key without checking
+         * if the association exists.
+         * 
+         * @param key a key that is known to have data associated to it
+         * (e.g. has_data(key) yields true).
+         * 
+         * @returns a reference to the value associated to the key.
+         */
+        inline T& get(const id_t key) noexcept
+        {
+            return data_[sparse_ref(key)];
+        }
+
+        /**
+         * Get the value associated to the supplied key without checking
+         * if the association exists.
+         * 
+         * @param key a key that is known to have data associated to it
+         * (e.g. has_data(key) yields true).
+         * 
+         * @returns a const reference to the value associated to the key.
+         */
+        inline const T& get(const id_t key) const noexcept
+        {
+            return data_[sparse_ref(key)];
+        }
+
+        /**
+         * Get the value associated to the supplied key if any, a single
+         * lookup that is cheap enough to be inlined on hot paths.
+         * 
+         * @param key the key whose value we want to retrieve.
+         * 
+         * @returns a pointer to the value or nullptr when the key has no
+         * data associated to it.
+         */
+        inline T* find(const id_t key) noexcept
+        {
+            const id_t position = index(key);
+
+            return is_null_key(position) ? nullptr : &data_[position];
+        }
+
+        /**
+         * Get the value associated to the supplied key if any, a single
+         * lookup that is cheap enough to be inlined on hot paths.
+         * 
+         * @param key the key whose value we want to retrieve.
+         * 
+         * @returns a pointer to the value or nullptr when the key has no
+         * data associated to it.
+         */
+        inline const T* find(const id_t key) const noexcept
+        {
+            const id_t position = index(key);
+
+            return is_null_key(position) ? nullptr : &data_[position];
+        }
+
+        /**
+         * Get the values of several keys at once (e.g. random accesses from
+         * scripts). The keys are processed in batches of PREFETCH_BATCH: the
+         * entries of the sparse array of the whole batch are prefetched, then
+         * the values, so the latency of the lookups overlaps instead of being
+         * paid once per key.
+         * 
+         * @tparam It a random access iterator over keys (id_t).
+         * @tparam OutputIt an output iterator of pointers to T.
+         * 
+         * @param first the first key of the range.
+         * @param last the end of the range.
+         * @param out where the values are written (nullptr for the keys 
+         * that have no data associated to them), one per key.
+         * 
+         * @returns the output iterator past the last written value.
+         */
+        template <typename It, typename OutputIt>
+        OutputIt get_many(It first, It last, OutputIt out)
+        {
+            return get_many(*this, first, last, out);
+        }
+
+        /**
+         * Const version of get_many, it writes pointers to const T.
+         */
+        template <typename It, typename OutputIt>
+        OutputIt get_many(It first, It last, OutputIt out) const
+        {
+            return get_many(*this, first, last, out);
+        }
+
+        /**
+         * Get the memory and occupancy of the arrays of the set.
+         * 
+         * @returns the statistics of the set (its type is left as MAX_ID).
+         */
+        virtual PoolStats stats() const noexcept override
+        {
+            PoolStats stats = BasicSparseSet::stats();
+
+            stats.size = size();
+            stats.bytes += data_.capacity() * sizeof(T) + holes_.capacity() * sizeof(id_t);
+
+            return stats;
+        }
+
+        /**
+         * Get the number of keys that have a value associated to them.
+         * 
+         * @returns the number of elements on the packed arrays (holes excluded).
+         */
+        inline size_t size() const noexcept
+        {
+            return dense_.size() - holes_.size();
+        }
+
+        /**
+         * Swap the position of two keys (and their values) on the packed 
+         * arrays.
+         * 
+         * @param a a key that has data associated to it.
+         * @param b a key that has data associated to it.
+         */
+        void swap(const id_t a, const id_t b)
+        {
+            const id_t a_index = sparse_ref(a);
+            const id_t b_index = sparse_ref(b);
+
+            std::swap(dense_[a_index], dense_[b_index]);
+            std::swap(data_[a_index], data_[b_index]);
+
+            sparse_ref(a) = b_index;
+            sparse_ref(b) = a_index;
+        }
+
+        /**
+         * Sort the keys and their values, iterating over the set (or a view
+         * driven by it) visits them in the new order.
+         *
+         * The sort starts from the current order thus, InsertionSort re-sorts
+         * a nearly sorted set (e.g. by depth every frame) in linear time.
+         *
+         * @tparam Compare a callable with the signature compare(const T&, const T&)
+         * or compare(id_t, id_t) that returns true if the first argument goes first
+         * (the values are compared when both signatures are valid).
+         * @tparam Sort the sorting algorithm (StdSort or InsertionSort).
+         *
+         * @param compare the comparison function.
+         * @param algorithm the sorting algorithm.
+         */
+        template <typename Compare, typename Sort = StdSort>
+        void sort(Compare compare, Sort algorithm = Sort{})
+        {
+            static_assert(!in_place_delete, "sorting moves the values, paged values must stay in place");
+
+            std::vector<id_t> order(dense_.size());
+
+            std::iota(order.begin(), order.end(), id_t{0});
+
+            if constexpr(std::is_invocable_r_v<bool, Compare&, const T&, const T&>)
+            {
+                algorithm(order.begin(), order.end(), [this, &compare](const id_t a, const id_t b)
+                {
+                    return compare(std::as_const(data_[a]), std::as_const(data_[b]));
+                });
+            }
+            else
+            {
+                algorithm(order.begin(), order.end(), [this, &compare](const id_t a, const id_t b)
+                {
+                    return compare(dense_[a], dense_[b]);
+                });
+            }
+
+            arrange(order);
+        }
+
+        /**
+         * Arrange the keys shared with another set in the same order they
+         * have on it, so iterating over both of them at the same time is
+         * sequential. The shared keys go first and the rest after them.
+         *
+         * @param other the set whose order will be followed.
+         *
+         * @returns the number of shared keys (the length of the ordered prefix).
+         */
+        size_t sort_as(const BasicSparseSet& other)
+        {
+            static_assert(!in_place_delete, "sorting moves the values, paged values must stay in place");
+
+            size_t next = 0;
+
+            for(const id_t key : other.keys())
+            {
+                if(!has_data(key))
+                    continue;
+
+                if(sparse_ref(key) != next)
+                    swap(key, dense_[next]);
+
+                ++next;
+            }
+
+            return next;
+        }
+
+        /**
+         * Get a pointer to the packed array of values. The i-th value
+         * is associated to the i-th key of the packed array of keys.
+         * 
+         * @returns a pointer to the first value (size() values can be accessed).
+         */
+        inline T* data() noexcept
+        {
+            static_assert(!in_place_delete, "paged values aren't contiguous");
+
+            return data_.data();
+        }
+
+        /**
+         * Get a pointer to the packed array of values. The i-th value
+         * is associated to the i-th key of the packed array of keys.
+         * 
+         * @returns a const pointer to the first value (size() values can be accessed).
+         */
+        inline const T* data() const noexcept
+        {
+            static_assert(!in_place_delete, "paged values aren't contiguous");
+
+            return data_.data();
+        }
+
+        /**
+         * Get an iterator to the first value of the packed array of values.
+         */
+        inline typename std::pmr::vector<T>::iterator begin() noexcept
+        {
+            static_assert(!in_place_delete, "paged values aren't contiguous");
+
+            return data_.begin();
+        }
+
+        /**
+         * Get an iterator past the last value of the packed array of values.
+         */
+        inline typename std::pmr::vector<T>::iterator end() noexcept
+        {
+            static_assert(!in_place_delete, "paged values aren't contiguous");
+
+            return data_.end();
+        }
+
+        /**
+         * Get a const iterator to the first value of the packed array of values.
+         */
+        inline typename std::pmr::vector<T>::const_iterator begin() const noexcept
+        {
+            static_assert(!in_place_delete, "paged values aren't contiguous");
+
+            return data_.begin();
+        }
+
+        /**
+         * Get a const iterator past the last value of the packed array of values.
+         */
+        inline typename std::pmr::vector<T>::const_iterator end() const noexcept
+        {
+            static_assert(!in_place_delete, "paged values aren't contiguous");
+
+            return data_.end();
+        }
+
         /**
          * Associate a key with a new instace of T if it doesn't
          * have a value associated with it already, update the 
@@ -114,26 +429,208 @@ namespace entis
             if(is_null_key(key))
                 return std::optional<error::BindError>{ error::BindError::INVALID_KEY };
 
-            // increase the size of the sparse set to hold new key.
+            // allocate the page of the sparse array that holds the new key.
             if(out_of_bounds(key))
-                rezise(key);
+                allocate_page(key);
+
+            const id_t index = sparse_index(key);
+
+            // reuse the hole left by the last unbind if any (in_place_delete).
+            if constexpr(in_place_delete)
+            {
+                if(is_null_key(index) && !holes_.empty())
+                {
+                    const id_t hole = holes_.back();
+
+                    data_.construct(hole, std::forward<Args>(args)...);
+                    holes_.pop_back();
+
+                    sparse_ref(key) = hole;
+                    dense_[hole] = key;
+
+                    return std::optional<error::BindError>{};
+                }
+            }
 
             // create new association and instance.
-            if(!has_data(key))
+            if(is_null_key(index))
             {
-                sparse_[key] = dense_.size();
+                sparse_ref(key) = dense_.size();
                 dense_.push_back(key);
-                data_.push_back(T(std::forward<Args>(args)...));
+                emplace(std::forward<Args>(args)...);
             }
-            // update the current association.
+            // update the current association (replacing an older version of the key if any).
             else
             {
-                data_[sparse_[key]] = T(std::forward<Args>(args)...);
+                dense_[index] = key;
+                replace(data_[index], std::forward<Args>(args)...);
             }
 
             return std::optional<error::BindError>{};
         }
 
+        /**
+         * Modify in place the value associated to a key if any.
+         * 
+         * Unlike bind, no new instance of T is created thus, it's the
+         * cheapest way of updating a value.
+         * 
+         * @tparam Fn a callable with the signature fn(T&).
+         * 
+         * @param key the key whose value we want to modify.
+         * @param fn the function applied to the value.
+         * 
+         * @returns true if the key has a value associated to it (and fn
+         * was applied), false otherwise.
+         */
+        template <typename Fn>
+        bool patch(const id_t key, Fn&& fn)
+        {
+            if(!has_data(key))
+                return false;
+
+            std::forward<Fn>(fn)(data_[sparse_ref(key)]);
+
+            return true;
+        }
+
+        /**
+         * Associate every key on a range with a copy of the same
+         * value (new instances are created from the same parameters).
+         * 
+         * The packed arrays grow once for the whole range instead of
+         * once per key.
+         * 
+         * @tparam It a forward iterator over keys (id_t).
+         * @tparam ...Args a packed list of values that will be passed
+         * to the constructor of T for every key.
+         * 
+         * @param first the first key of the range.
+         * @param last the end of the range.
+         * 
+         * @returns an optional with a BindError::INVALID_KEY when the range
+         * contains the null key (the rest of the keys are bound anyway) and
+         * an empty optional otherwise.
+         */
+        template <typename It, typename... Args>
+        std::optional<error::BindError> bind_range(It first, It last, const Args&... args)
+        {
+            std::optional<error::BindError> result{};
+
+            reserve(dense_.size() + static_cast<size_t>(std::distance(first, last)));
+
+            for(; first != last; ++first)
+            {
+                if(bind(*first, args...))
+                    result = error::BindError::INVALID_KEY;
+            }
+
+            return result;
+        }
+
+        /**
+         * Associate every key on a range with the value at the same
+         * position on a second range.
+         * 
+         * The packed arrays grow once for the whole range instead of
+         * once per key.
+         * 
+         * @tparam It a forward iterator over keys (id_t).
+         * @tparam ValueIt an iterator over values of type T.
+         * 
+         * @param first the first key of the range.
+         * @param last the end of the range.
+         * @param values the first value, there must be as many values as keys.
+         * 
+         * @returns an optional with a BindError::INVALID_KEY when the range
+         * contains the null key (the rest of the keys are bound anyway) and
+         * an empty optional otherwise.
+         */
+        template <typename It, typename ValueIt>
+        std::optional<error::BindError> insert(It first, It last, ValueIt values)
+        {
+            std::optional<error::BindError> result{};
+
+            reserve(dense_.size() + static_cast<size_t>(std::distance(first, last)));
+
+            for(; first != last; ++first, ++values)
+            {
+                if(bind(*first, *values))
+                    result = error::BindError::INVALID_KEY;
+            }
+
+            return result;
+        }
+
+        /**
+         * Fill an empty set with the keys of a range and the values at the
+         * same positions of a second range in bulk (e.g. when loading a
+         * snapshot): the packed arrays are copied at once (a memcpy for
+         * trivially copyable values) and the sparse array is rebuilt.
+         * 
+         * @tparam It a random access iterator over keys (id_t).
+         * @tparam ValueIt a random access iterator over values of type T.
+         * 
+         * @param first the first key of the range (the keys must be unique
+         * and different from the null key).
+         * @param last the end of the range.
+         * @param values the first value, there must be as many values as keys.
+         */
+        template <typename It, typename ValueIt>
+        void assign(It first, It last, ValueIt values)
+        {
+            assert(dense_.empty() && "only empty sets can be assigned");
+
+            const size_t count = static_cast<size_t>(std::distance(first, last));
+
+            dense_.assign(first, last);
+
+            if constexpr(in_place_delete)
+            {
+                data_.reserve(count);
+
+                for(size_t i = 0; i < count; ++i)
+                    data_.emplace_back(values[i]);
+            }
+            else
+            {
+                data_.assign(values, values + count);
+            }
+
+            for(size_t i = 0; i < count; ++i)
+            {
+                const id_t key = dense_[i];
+
+                if(out_of_bounds(key))
+                    allocate_page(key);
+
+                sparse_ref(key) = static_cast<id_t>(i);
+            }
+        }
+
+        /**
+         * Allocate enough space on the packed arrays to hold
+         * the specified number of values without growing.
+         * 
+         * @param capacity the number of values.
+         * 
+         * @throws an exception whenever std::vector can't grow.
+         */
+        void reserve(const size_t capacity)
+        {
+            dense_.reserve(capacity);
+            data_.reserve(capacity);
+        }
+
+        /**
+         * Get the number of values the packed arrays can hold
+         * without growing.
+         */
+        inline size_t capacity() const noexcept
+        {
+            return dense_.capacity();
+        }
+
         /**
          * Delete the association between a key and its value
          * if any. 
@@ -154,24 +651,34 @@ namespace entis
 
             if(has_data(key))
             {
-                const id_t packed_index = sparse_[key];
-
-                sparse_[dense_.back()] = packed_index;
-                sparse_[key] = MAX_ID;
-
-                std::swap(dense_[packed_index], dense_.back());
-                std::swap(data_[packed_index], data_.back());
-
                 // pass ownership to the optional
-                result = std::move(data_.back());
+                result.emplace(std::move(data_[sparse_ref(key)]));
 
-                data_.pop_back();
-                dense_.pop_back();
+                remove(key);
             }
 
             return result;
         }
 
+        /**
+         * Delete the association between a key and its value if any
+         * without passing the value to the caller (cheaper than unbind
+         * when the value isn't needed).
+         * 
+         * @param key the key whose association we want to delete.
+         * 
+         * @returns true if the key had a value associated to it, false otherwise.
+         */
+        bool erase(const id_t key)
+        {
+            if(!has_data(key))
+                return false;
+
+            remove(key);
+
+            return true;
+        }
+
         /**
          * Delete the association between an entity and its component
          * if any.
@@ -180,63 +687,245 @@ namespace entis
          */
         virtual void delete_component(const id_t entity) override
         {
-            unbind(entity);
+            erase(entity);
+        }
+
+        /**
+         * Release the unused pages of the sparse array and the excess capacity
+         * of the packed arrays. The values of the paged layout keep their
+         * address thus, only its keys are shrunk.
+         */
+        virtual void shrink_to_fit() override
+        {
+            BasicSparseSet::shrink_to_fit();
+
+            if constexpr(!in_place_delete)
+                data_.shrink_to_fit();
+
+            holes_.shrink_to_fit();
+        }
+
+        /**
+         * Remove the holes left by unbind (in_place_delete) by moving the
+         * values after them forward, the relative order of the values is kept.
+         * 
+         * Pointers to the moved values are invalidated thus, it should be called
+         * at known points (e.g. between frames or levels). Without in_place_delete
+         * there are no holes and it does nothing.
+         */
+        void compact()
+        {
+            if constexpr(in_place_delete)
+            {
+                size_t next = 0;
+
+                for(size_t i = 0; i < dense_.size(); ++i)
+                {
+                    const id_t key = dense_[i];
+
+                    if(is_null_key(key))
+                        continue;
+
+                    if(i != next)
+                    {
+                        data_.construct(next, std::move(data_[i]));
+                        data_.destroy(i);
+
+                        dense_[next] = key;
+                        sparse_ref(key) = static_cast<id_t>(next);
+                    }
+
+                    ++next;
+                }
+
+                dense_.resize(next);
+                data_.truncate(next);
+                holes_.clear();
+            }
         }
 
     private:
 
-        std::vector<id_t> sparse_;
-        std::vector<id_t> dense_;
-        std::vector<T> data_;
+        std::conditional_t<in_place_delete, 
+                           PagedStorage<T, storage_traits<T>::page_size>, std::pmr::vector<T>> data_;
+        std::pmr::vector<id_t> holes_; // packed positions left by unbind (only with in_place_delete).
+
+        /**
+         * Implementation of get_many shared by the const and non-const versions.
+         */
+        template <typename Self, typename It, typename OutputIt>
+        static OutputIt get_many(Self& self, It first, It last, OutputIt out)
+        {
+            id_t positions[PREFETCH_BATCH];
+
+            while(first != last)
+            {
+                const size_t count = std::min<size_t>(PREFETCH_BATCH, static_cast<size_t>(last - first));
+
+                for(size_t i = 0; i < count; ++i)
+                    self.prefetch(first[i]);
+
+                // the packed key and the value are prefetched before checking the key.
+                for(size_t i = 0; i < count; ++i)
+                {
+                    positions[i] = self.sparse_index(first[i]);
+
+                    if(positions[i] < self.dense_.size())
+                    {
+                        ENTIS_PREFETCH(&self.dense_[positions[i]]);
+                        ENTIS_PREFETCH(&self.data_[positions[i]]);
+                    }
+                }
+
+                for(size_t i = 0; i < count; ++i)
+                {
+                    const id_t position = positions[i];
+                    const bool found = position < self.dense_.size() && self.dense_[position] == first[i];
+
+                    *out++ = found ? &self.data_[position] : nullptr;
+                }
+
+                first += count;
+            }
+
+            return out;
+        }
 
         /**
-         * Check if the sparse array has enough space
-         * to hold the specified key.
+         * Delete the association between a key and its value without 
+         * passing the value to the caller.
          * 
-         * @param the key that we want to test.
+         * Packed values are filled with the last value (swap and pop) while
+         * paged ones are destroyed in place leaving a hole.
          * 
-         * @returns true if there's enough space on the
-         * sparse array so the key can be used to index it,
-         * false otherwise.
+         * @param key a key that has data associated to it.
          */
-        inline bool out_of_bounds(const id_t key) noexcept
+        void remove(const id_t key)
         {
-            return key >= sparse_.size();
+            const id_t packed_index = sparse_ref(key);
+
+            sparse_ref(key) = MAX_ID;
+
+            if constexpr(in_place_delete)
+            {
+                data_.destroy(packed_index);
+                dense_[packed_index] = MAX_ID;
+                holes_.push_back(packed_index);
+            }
+            else
+            {
+                const id_t last = dense_.back();
+
+                if(last != key)
+                {
+                    sparse_ref(last) = packed_index;
+                    dense_[packed_index] = last;
+                    data_[packed_index] = std::move(data_.back());
+                }
+
+                dense_.pop_back();
+                data_.pop_back();
+            }
         }
 
         /**
-         * Check if the key is not the null key
-         * 
-         * @param the key we want to test.
+         * Move the keys and values so the i-th position holds the ones that
+         * were on order[i], following each cycle of the permutation.
+         *
+         * @param order a permutation of the packed positions (it is consumed).
+         */
+        void arrange(std::vector<id_t>& order)
+        {
+            for(id_t start = 0; start < order.size(); ++start)
+            {
+                if(order[start] == start)
+                    continue;
+
+                const id_t key = dense_[start];
+                T value = std::move(data_[start]);
+
+                id_t current = start;
+
+                for(; order[current] != start; current = std::exchange(order[current], current))
+                {
+                    dense_[current] = dense_[order[current]];
+                    data_[current] = std::move(data_[order[current]]);
+
+                    sparse_ref(dense_[current]) = current;
+                }
+
+                order[current] = current;
+
+                dense_[current] = key;
+                data_[current] = std::move(value);
+
+                sparse_ref(key) = current;
+            }
+        }
+
+        /**
+         * Construct a new value at the back of the packed array of values
+         * without creating a temporary. Aggregates (types without a matching
+         * constructor) are brace-initialized.
          * 
-         * @returns true if the key is the MAX_ID and false
-         * otherwise.
+         * @tparam ...Args a packed list of values that will be 
+         * perfectly-forwarded to the constructor of T.
          */
-        inline bool is_null_key(const id_t key) noexcept
+        template <typename... Args>
+        inline void emplace(Args&&... args)
         {
-            return key == MAX_ID;
+            if constexpr(in_place_delete || std::is_constructible_v<T, Args&&...>)
+                data_.emplace_back(std::forward<Args>(args)...);
+            else
+                data_.push_back(T{std::forward<Args>(args)...});
         }
 
         /**
-         * Allocate new space on the sparse array to
-         * hold the specified key.
+         * Replace an existing value with a new instance of T.
          * 
-         * @param key the key that we want the sparse set to be
-         * able to store.
+         * A single T is assigned directly (copy or move). Otherwise the new
+         * instance is constructed on scratch storage from the memory resource
+         * of the set (uses-allocator construction, like the values made by
+         * emplace) and moved into the old one. The arguments may refer to the
+         * old value, since it is alive until the new one exists. Aggregates
+         * (types without a matching constructor) are brace-initialized.
          * 
-         * @returns how much new space was allocated (number
-         * of items).
+         * @tparam ...Args a packed list of values that will be 
+         * perfectly-forwarded to the constructor of T.
+         * 
+         * @param value the value to replace.
          */
-        size_t rezise(const id_t key)
+        template <typename... Args>
+        inline void replace(T& value, Args&&... args)
         {
-            const size_t from = sparse_.size();
-            const size_t to = key - sparse_.size();
+            if constexpr(sizeof...(Args) == 1 && (std::is_same_v<std::decay_t<Args>, T> && ...))
+            {
+                value = (std::forward<Args>(args), ...);
+            }
+            else
+            {
+                std::pmr::polymorphic_allocator<T> allocator{resource()};
+
+                alignas(T) unsigned char scratch[sizeof(T)];
 
-            sparse_.resize(key + 1);
+                if constexpr(std::is_constructible_v<T, Args&&...>)
+                    allocator.construct(reinterpret_cast<T*>(scratch), std::forward<Args>(args)...);
+                else
+                    allocator.construct(reinterpret_cast<T*>(scratch), T{std::forward<Args>(args)...});
 
-            std::fill(sparse_.begin() + from, sparse_.end() + to, MAX_ID);
+                // the temporary is destroyed even if the assignment throws.
+                struct Temporary
+                {
+                    ~Temporary()
+                    {
+                        value->~T();
+                    }
 
-            return to;
+                    T* value;
+                } temporary{std::launder(reinterpret_cast<T*>(scratch))};
+
+                value = std::move(*temporary.value);
+            }
         }
     };
 }
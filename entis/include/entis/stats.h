@@ -0,0 +1,257 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "config.h"
+
+namespace entis
+{
+    /**
+     * Memory and occupancy of a component manager (see Registry::pool_stats),
+     * always available since they are computed on demand.
+     */
+    struct PoolStats
+    {
+        id_t type;           // TypeIndex of the component.
+        size_t size;         // number of components (holes excluded).
+        size_t capacity;     // number of components the packed arrays can hold without growing.
+        size_t sparse_pages; // number of allocated pages of the sparse array.
+        size_t bytes;        // bytes reserved by the arrays (memory owned by the components excluded).
+    };
+
+    /**
+     * Function called with the name, start and end (in nanoseconds since the
+     * epoch of std::chrono::steady_clock) of every profiled scope, e.g. to
+     * forward them to Tracy or Perfetto as complete events.
+     */
+    using ProfileHook = void (*)(const char* name, uint64_t begin, uint64_t end);
+
+    /**
+     * Get the function that receives the profiled scopes (none by default).
+     * It must be set before the scopes run, it isn't synchronized.
+     */
+    inline ProfileHook& profile_hook() noexcept
+    {
+        static ProfileHook hook = nullptr;
+
+        return hook;
+    }
+
+    namespace detail
+    {
+        /**
+         * Get the current time in nanoseconds.
+         */
+        inline uint64_t now() noexcept
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+    }
+
+    /**
+     * Reports the time spent on a scope to the profile hook (see
+     * ENTIS_PROFILE_SCOPE).
+     */
+    class ScopedTimer
+    {
+    public:
+
+        /**
+         * Start timing a scope.
+         *
+         * @param name the name of the scope, it must outlive the timer.
+         */
+        explicit ScopedTimer(const char* name) noexcept
+        : name_{name},
+          begin_{detail::now()}
+        {
+
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+        /**
+         * Report the scope to the profile hook if any.
+         */
+        ~ScopedTimer()
+        {
+            if(const ProfileHook hook = profile_hook())
+                hook(name_, begin_, detail::now());
+        }
+
+    private:
+
+        const char* name_;
+        uint64_t begin_;
+    };
+
+#ifdef ENTIS_ENABLE_STATS
+
+    /**
+     * Counters of the structural changes of a registry (see Registry::stats).
+     */
+    struct RegistryStats
+    {
+        uint64_t created = 0;  // entities created.
+        uint64_t killed = 0;   // entities killed.
+        uint64_t bound = 0;    // components bound (new ones and replacements).
+        uint64_t unbound = 0;  // components removed (killed entities included).
+    };
+
+    /**
+     * Counters of the iterations of every view with the same components (a
+     * query signature), shared by every registry. They are updated atomically
+     * since views can be iterated from several threads.
+     */
+    struct QueryStats
+    {
+        const char* name;                      // name of the view type.
+        std::atomic<uint64_t> calls{0};        // number of iterations (each, each_par and query).
+        std::atomic<uint64_t> scanned{0};      // keys of the driver visited.
+        std::atomic<uint64_t> matched{0};      // entities that satisfied the view.
+        std::atomic<uint64_t> nanoseconds{0};  // time spent iterating.
+
+        explicit QueryStats(const char* name) noexcept
+        : name{name}
+        {
+
+        }
+
+        /**
+         * Set every counter to zero.
+         */
+        void reset() noexcept
+        {
+            calls = 0;
+            scanned = 0;
+            matched = 0;
+            nanoseconds = 0;
+        }
+    };
+
+    namespace detail
+    {
+        /**
+         * Every QueryStats created so far.
+         */
+        struct QueryStatsList
+        {
+            std::mutex mutex;
+            std::vector<QueryStats*> stats;
+        };
+
+        inline QueryStatsList& query_stats_list()
+        {
+            static QueryStatsList list{};
+
+            return list;
+        }
+
+        /**
+         * Get a readable name of a type (the signature of this function on
+         * GCC and Clang).
+         */
+        template <typename T>
+        const char* type_name() noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return __PRETTY_FUNCTION__;
+#else
+            return __FUNCSIG__;
+#endif
+        }
+
+        /**
+         * Get the counters of a query signature, they are created (and
+         * listed) the first time they are requested.
+         *
+         * @tparam T the type of the view.
+         */
+        template <typename T>
+        QueryStats& query_stats_of()
+        {
+            static QueryStats& stats = []() -> QueryStats&
+            {
+                static QueryStats instance{type_name<T>()};
+
+                QueryStatsList& list = query_stats_list();
+                std::lock_guard<std::mutex> lock{list.mutex};
+
+                list.stats.push_back(&instance);
+
+                return instance;
+            }();
+
+            return stats;
+        }
+
+        /**
+         * Updates the counters of a query signature when an iteration ends
+         * and reports it to the profile hook.
+         */
+        class QueryScope
+        {
+        public:
+
+            QueryScope(QueryStats& stats, const size_t scanned) noexcept
+            : matched{0},
+              stats_{stats},
+              scanned_{scanned},
+              begin_{now()}
+            {
+
+            }
+
+            QueryScope(const QueryScope&) = delete;
+
+            QueryScope& operator=(const QueryScope&) = delete;
+
+            ~QueryScope()
+            {
+                const uint64_t end = now();
+
+                stats_.calls.fetch_add(1, std::memory_order_relaxed);
+                stats_.scanned.fetch_add(scanned_, std::memory_order_relaxed);
+                stats_.matched.fetch_add(matched, std::memory_order_relaxed);
+                stats_.nanoseconds.fetch_add(end - begin_, std::memory_order_relaxed);
+
+                if(const ProfileHook hook = profile_hook())
+                    hook(stats_.name, begin_, end);
+            }
+
+            std::atomic<uint64_t> matched; // incremented by the iteration.
+
+        private:
+
+            QueryStats& stats_;
+            uint64_t scanned_;
+            uint64_t begin_;
+        };
+    }
+
+    /**
+     * Get the counters of every query signature iterated so far.
+     *
+     * @returns pointers to the counters (valid for the rest of the program).
+     */
+    inline std::vector<QueryStats*> query_stats()
+    {
+        detail::QueryStatsList& list = detail::query_stats_list();
+        std::lock_guard<std::mutex> lock{list.mutex};
+
+        return list.stats;
+    }
+
+#endif
+}
+
+#endif
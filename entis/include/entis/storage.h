@@ -0,0 +1,223 @@
+#ifndef STORAGE_H
+#define STORAGE_H
+
+#include <new>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+#include <memory_resource>
+
+namespace entis
+{
+    /**
+     * Chooses how a SparseSet lays out the values of a component T.
+     *
+     * By default the values are tightly packed on a std::vector (the fastest
+     * layout to iterate over), growing it moves every value and unbinding
+     * moves the last value into the hole. Specialize it to use a paged layout
+     * with stable addresses instead:
+     *
+     * template <>
+     * struct entis::storage_traits<Animation>
+     * {
+     *     static constexpr bool in_place_delete = true;
+     *     static constexpr size_t page_size = 64;
+     * };
+     *
+     * @tparam T the type of the component.
+     */
+    template <typename T>
+    struct storage_traits
+    {
+        /// Whether values stay at the same address until they are unbound (paged layout).
+        static constexpr bool in_place_delete = false;
+
+        /// Number of values per page of the paged layout (must be a power of two).
+        static constexpr size_t page_size = 128;
+    };
+
+    /**
+     * Uninitialized memory for values of type T split in pages of PageSize
+     * values. Pages are allocated on demand and never moved thus, the address
+     * of a value doesn't change when the storage grows.
+     *
+     * The storage doesn't track which slots hold a value, its owner constructs
+     * and destroys them (construct, destroy, emplace_back) and it must destroy
+     * every live value before the storage is destroyed. The pages are
+     * allocated from the memory resource the storage was created with.
+     *
+     * @tparam T the type of the values.
+     * @tparam PageSize the number of values per page (a power of two).
+     */
+    template <typename T, size_t PageSize>
+    class PagedStorage
+    {
+        static_assert(PageSize > 0 && (PageSize & (PageSize - 1)) == 0, "page_size must be a power of two");
+
+    public:
+
+        /**
+         * Create an empty storage without pages.
+         *
+         * @param resource the memory resource the pages are allocated from, it
+         * must outlive the storage.
+         */
+        explicit PagedStorage(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : pages_{resource},
+          size_{0}
+        {
+
+        }
+
+        PagedStorage(const PagedStorage&) = delete;
+
+        PagedStorage& operator=(const PagedStorage&) = delete;
+
+        /**
+         * Release the pages (the values must have been destroyed already).
+         */
+        ~PagedStorage()
+        {
+            for(Slot* page : pages_)
+                pages_.get_allocator().resource()->deallocate(page, PageSize * sizeof(Slot), alignof(Slot));
+        }
+
+        /**
+         * Get the value on the specified slot.
+         *
+         * @param index a slot that holds a value.
+         */
+        inline T& operator[](const size_t index) noexcept
+        {
+            return *std::launder(reinterpret_cast<T*>(address(index)));
+        }
+
+        /**
+         * Get the value on the specified slot.
+         *
+         * @param index a slot that holds a value.
+         */
+        inline const T& operator[](const size_t index) const noexcept
+        {
+            return *std::launder(reinterpret_cast<const T*>(address(index)));
+        }
+
+        /**
+         * Get the number of slots in use (live values and holes).
+         */
+        inline size_t size() const noexcept
+        {
+            return size_;
+        }
+
+        /**
+         * Get the number of slots that can be used without allocating pages.
+         */
+        inline size_t capacity() const noexcept
+        {
+            return pages_.size() * PageSize;
+        }
+
+        /**
+         * Allocate enough pages to hold the specified number of slots.
+         *
+         * @param capacity the number of slots.
+         *
+         * @throws an exception whenever a page can't be allocated.
+         */
+        void reserve(const size_t capacity)
+        {
+            std::pmr::memory_resource* resource = pages_.get_allocator().resource();
+
+            pages_.reserve((capacity + PageSize - 1) / PageSize);
+
+            while(this->capacity() < capacity)
+                pages_.push_back(static_cast<Slot*>(resource->allocate(PageSize * sizeof(Slot), alignof(Slot))));
+        }
+
+        /**
+         * Construct a new value on a new slot at the end of the storage.
+         *
+         * @tparam ...Args a packed list of values that will be
+         * perfectly-forwarded to the constructor of T.
+         *
+         * @returns a reference to the new value.
+         */
+        template <typename... Args>
+        T& emplace_back(Args&&... args)
+        {
+            reserve(size_ + 1);
+
+            T& value = construct(size_, std::forward<Args>(args)...);
+
+            ++size_;
+
+            return value;
+        }
+
+        /**
+         * Construct a value on an empty slot. Aggregates (types without a
+         * matching constructor) are brace-initialized.
+         *
+         * @tparam ...Args a packed list of values that will be
+         * perfectly-forwarded to the constructor of T.
+         *
+         * @param index a slot that doesn't hold a value.
+         *
+         * @returns a reference to the new value.
+         */
+        template <typename... Args>
+        inline T& construct(const size_t index, Args&&... args)
+        {
+            if constexpr(std::is_constructible_v<T, Args&&...>)
+                return *::new(address(index)) T(std::forward<Args>(args)...);
+            else
+                return *::new(address(index)) T{std::forward<Args>(args)...};
+        }
+
+        /**
+         * Destroy the value of a slot, the slot stays in use.
+         *
+         * @param index a slot that holds a value.
+         */
+        inline void destroy(const size_t index) noexcept
+        {
+            (*this)[index].~T();
+        }
+
+        /**
+         * Release the slots past the specified size (they mustn't hold values).
+         *
+         * @param size the new number of slots in use.
+         */
+        inline void truncate(const size_t size) noexcept
+        {
+            size_ = size;
+        }
+
+    private:
+
+        /**
+         * Raw memory for a single value.
+         */
+        struct Slot
+        {
+            alignas(T) unsigned char bytes[sizeof(T)];
+        };
+
+        std::pmr::vector<Slot*> pages_;
+        size_t size_;
+
+        /**
+         * Get the memory of the specified slot.
+         */
+        inline void* address(const size_t index) const noexcept
+        {
+            return pages_[index / PageSize][index & (PageSize - 1)].bytes;
+        }
+    };
+}
+
+#endif
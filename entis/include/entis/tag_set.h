@@ -0,0 +1,338 @@
+#ifndef TAG_SET_H
+#define TAG_SET_H
+
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <optional>
+#include <functional>
+#include <type_traits>
+#include <memory_resource>
+
+#include "error.h"
+#include "config.h"
+#include "basic_sparse_set.h"
+
+namespace entis
+{
+    /**
+     * Check if a component T is a tag, this is, an empty type used as a
+     * marker (e.g. struct Dead {}) whose only information is whether an
+     * entity has it or not.
+     *
+     * Empty types that can't be default-constructed aren't tags since the
+     * shared instance of a TagSet couldn't be made, they are stored on a
+     * SparseSet like any other component.
+     *
+     * @tparam T the type of the component.
+     */
+    template <typename T>
+    struct is_tag : std::conjunction<std::is_empty<T>, std::is_default_constructible<T>>
+    {
+    };
+
+    template <typename T>
+    inline constexpr bool is_tag_v = is_tag<T>::value;
+
+    /**
+     * A sparse set for tags: it only stores which keys have the tag T
+     * (the sparse and packed arrays of keys), no values are constructed
+     * nor stored.
+     *
+     * Since every instance of an empty type is the same, getting the tag
+     * of a key yields a reference to a single shared instance.
+     *
+     * @tparam T the type of the tag.
+     */
+    template <typename T>
+    class TagSet : public BasicSparseSet
+    {
+        static_assert(is_tag_v<T>, "a TagSet can only store empty, default-constructible types");
+
+    public:
+
+        /// Tags are always packed.
+        static constexpr bool in_place_delete = false;
+
+        /**
+         * Create an empty set.
+         *
+         * @param resource the memory resource the arrays are allocated from, it
+         * must outlive the set.
+         */
+        explicit TagSet(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : BasicSparseSet{resource},
+          instance_{}
+        {
+
+        }
+
+        /**
+         * Get the number of keys that have the tag.
+         */
+        inline size_t size() const noexcept
+        {
+            return dense_.size();
+        }
+
+        /**
+         * Get the tag of a key if any.
+         *
+         * @param key the key whose tag we want.
+         *
+         * @returns an optional with a reference to the shared instance of T
+         * when the key has the tag and an empty optional otherwise.
+         */
+        std::optional<std::reference_wrapper<const T>> get_data(const id_t key) const
+        {
+            std::optional<std::reference_wrapper<const T>> result{};
+
+            if(has_data(key))
+                result = std::cref(instance_);
+
+            return result;
+        }
+
+        /**
+         * Get the tag of a key if any.
+         *
+         * @param key the key whose tag we want.
+         *
+         * @returns an optional with a reference to the shared instance of T
+         * when the key has the tag and an empty optional otherwise.
+         */
+        std::optional<std::reference_wrapper<T>> get_data(const id_t key)
+        {
+            std::optional<std::reference_wrapper<T>> result{};
+
+            if(has_data(key))
+                result = std::ref(instance_);
+
+            return result;
+        }
+
+        /**
+         * Add the tag to a key. Nothing is constructed, the arguments are
+         * only checked to be valid for constructing a T.
+         *
+         * @param key the key that will have the tag.
+         *
+         * @returns an optional with a BindError::INVALID_KEY when the key is
+         * the null key (MAX_ID) and an empty optional otherwise.
+         */
+        template <typename... Args>
+        std::optional<error::BindError> bind(const id_t key, Args&&...)
+        {
+            static_assert(std::is_constructible_v<T, Args&&...> || sizeof...(Args) == 0,
+                          "the arguments can't construct the tag");
+
+            if(is_null_key(key))
+                return std::optional<error::BindError>{ error::BindError::INVALID_KEY };
+
+            if(out_of_bounds(key))
+                allocate_page(key);
+
+            const id_t index = sparse_index(key);
+
+            if(is_null_key(index))
+            {
+                sparse_ref(key) = dense_.size();
+                dense_.push_back(key);
+            }
+            // replace an older version of the key if any.
+            else
+            {
+                dense_[index] = key;
+            }
+
+            return std::optional<error::BindError>{};
+        }
+
+        /**
+         * Apply a function to the tag of a key if any.
+         *
+         * @tparam Fn a callable with the signature fn(T&).
+         *
+         * @param key the key whose tag we want.
+         * @param fn the function applied to the tag.
+         *
+         * @returns true if the key has the tag, false otherwise.
+         */
+        template <typename Fn>
+        bool patch(const id_t key, Fn&& fn)
+        {
+            if(!has_data(key))
+                return false;
+
+            std::forward<Fn>(fn)(instance_);
+
+            return true;
+        }
+
+        /**
+         * Add the tag to every key on a range.
+         *
+         * @tparam It a forward iterator over keys (id_t).
+         *
+         * @param first the first key of the range.
+         * @param last the end of the range.
+         *
+         * @returns an optional with a BindError::INVALID_KEY when the range
+         * contains the null key (the rest of the keys are bound anyway) and
+         * an empty optional otherwise.
+         */
+        template <typename It, typename... Args>
+        std::optional<error::BindError> bind_range(It first, It last, const Args&...)
+        {
+            std::optional<error::BindError> result{};
+
+            reserve(dense_.size() + static_cast<size_t>(std::distance(first, last)));
+
+            for(; first != last; ++first)
+            {
+                if(bind(*first))
+                    result = error::BindError::INVALID_KEY;
+            }
+
+            return result;
+        }
+
+        /**
+         * Allocate enough space on the packed array of keys to hold the
+         * specified number of keys without growing.
+         *
+         * @param capacity the number of keys.
+         */
+        void reserve(const size_t capacity)
+        {
+            dense_.reserve(capacity);
+        }
+
+        /**
+         * Get the number of keys the packed array can hold without growing.
+         */
+        inline size_t capacity() const noexcept
+        {
+            return dense_.capacity();
+        }
+
+        /**
+         * Swap the position of two keys on the packed array.
+         *
+         * @param a a key that has the tag.
+         * @param b a key that has the tag.
+         */
+        void swap(const id_t a, const id_t b)
+        {
+            const id_t a_index = sparse_ref(a);
+            const id_t b_index = sparse_ref(b);
+
+            std::swap(dense_[a_index], dense_[b_index]);
+
+            sparse_ref(a) = b_index;
+            sparse_ref(b) = a_index;
+        }
+
+        /**
+         * Arrange the keys shared with another set in the same order they
+         * have on it. The shared keys go first and the rest after them.
+         *
+         * @param other the set whose order will be followed.
+         *
+         * @returns the number of shared keys (the length of the ordered prefix).
+         */
+        size_t sort_as(const BasicSparseSet& other)
+        {
+            size_t next = 0;
+
+            for(const id_t key : other.keys())
+            {
+                if(!has_data(key))
+                    continue;
+
+                if(sparse_ref(key) != next)
+                    swap(key, dense_[next]);
+
+                ++next;
+            }
+
+            return next;
+        }
+
+        /**
+         * Remove the tag from a key if any.
+         *
+         * @param key the key whose tag we want to remove.
+         *
+         * @returns an optional with a T when the key had the tag, an empty
+         * optional otherwise.
+         */
+        std::optional<T> unbind(const id_t key)
+        {
+            std::optional<T> result{};
+
+            if(has_data(key))
+            {
+                result.emplace();
+
+                remove(key);
+            }
+
+            return result;
+        }
+
+        /**
+         * Remove the tag from a key if any.
+         *
+         * @param key the key whose tag we want to remove.
+         *
+         * @returns true if the key had the tag, false otherwise.
+         */
+        bool erase(const id_t key)
+        {
+            if(!has_data(key))
+                return false;
+
+            remove(key);
+
+            return true;
+        }
+
+        /**
+         * Remove the tag from an entity if any.
+         *
+         * @param entity the entity whose tag we want to remove.
+         */
+        virtual void delete_component(const id_t entity) override
+        {
+            erase(entity);
+        }
+
+    private:
+
+        T instance_; // the instance shared by every key.
+
+        /**
+         * Remove the tag from a key, the last key fills the hole.
+         *
+         * @param key a key that has the tag.
+         */
+        void remove(const id_t key)
+        {
+            const id_t packed_index = sparse_ref(key);
+            const id_t last = dense_.back();
+
+            sparse_ref(key) = MAX_ID;
+
+            if(last != key)
+            {
+                sparse_ref(last) = packed_index;
+                dense_[packed_index] = last;
+            }
+
+            dense_.pop_back();
+        }
+    };
+}
+
+#endif
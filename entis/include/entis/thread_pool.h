@@ -0,0 +1,273 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <condition_variable>
+
+namespace entis
+{
+    /**
+     * A fixed-size, work-stealing pool of worker threads used to run tasks
+     * in parallel (e.g. the chunks of a parallel view iteration or the
+     * systems of a Scheduler).
+     *
+     * Every worker has its own queue: tasks submitted from a worker go to
+     * its queue (and are run LIFO by it) while idle workers steal the oldest
+     * tasks of the rest of the queues. Threads that wait for a batch of tasks
+     * to finish (parallel_for) run pending tasks meanwhile so, batches can be
+     * nested without deadlocks. Tasks must not throw.
+     */
+    class ThreadPool
+    {
+    public:
+
+        /**
+         * Create a pool with the specified number of worker threads.
+         *
+         * @param threads the number of workers (at least one is created).
+         */
+        explicit ThreadPool(const size_t threads = std::thread::hardware_concurrency())
+        : workers_{},
+          queues_{},
+          pending_{0},
+          next_{0},
+          mutex_{},
+          condition_{},
+          stop_{false}
+        {
+            const size_t count = std::max<size_t>(threads, 1);
+
+            queues_.reserve(count);
+            workers_.reserve(count);
+
+            for(size_t i = 0; i < count; ++i)
+                queues_.push_back(std::make_unique<Queue>());
+
+            for(size_t i = 0; i < count; ++i)
+                workers_.emplace_back([this, i]{ work(i); });
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /**
+         * Finish the pending tasks and join the worker threads.
+         */
+        ~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock{mutex_};
+                stop_ = true;
+            }
+
+            condition_.notify_all();
+
+            for(std::thread& worker : workers_)
+                worker.join();
+        }
+
+        /**
+         * Get the number of worker threads.
+         */
+        inline size_t size() const noexcept
+        {
+            return workers_.size();
+        }
+
+        /**
+         * Queue a task to be run by some worker. When called from a worker
+         * of this pool the task goes to its own queue, otherwise the queues
+         * are filled in a round-robin fashion.
+         *
+         * @param task the task to run.
+         */
+        void submit(std::function<void()> task)
+        {
+            const size_t index = (current_pool() == this) ?
+                current_index() : next_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+
+            // count the task before it can be taken so the counter never underflows.
+            {
+                std::lock_guard<std::mutex> lock{mutex_};
+                pending_.fetch_add(1, std::memory_order_release);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock{queues_[index]->mutex};
+                queues_[index]->tasks.push_back(std::move(task));
+            }
+
+            condition_.notify_one();
+        }
+
+        /**
+         * Split the range [0, count) in chunks of (at most) grain elements
+         * and run fn(begin, end) for each of them on the workers. The calling
+         * thread helps running tasks and returns once all chunks are done.
+         *
+         * @tparam Fn a callable with the signature fn(size_t begin, size_t end).
+         *
+         * @param count the number of elements of the range.
+         * @param grain the maximum number of elements per chunk.
+         * @param fn the function applied to every chunk.
+         */
+        template <typename Fn>
+        void parallel_for(const size_t count, const size_t grain, Fn&& fn)
+        {
+            const size_t chunk = std::max<size_t>(grain, 1);
+            const size_t chunks = (count + chunk - 1) / chunk;
+
+            std::atomic<size_t> remaining{chunks};
+
+            for(size_t i = 0; i < chunks; ++i)
+            {
+                const size_t begin = i * chunk;
+                const size_t end = std::min(begin + chunk, count);
+
+                submit([&fn, &remaining, begin, end]
+                {
+                    fn(begin, end);
+                    remaining.fetch_sub(1, std::memory_order_release);
+                });
+            }
+
+            wait(remaining);
+        }
+
+        /**
+         * Run pending tasks on the calling thread until the counter
+         * reaches zero.
+         *
+         * @param remaining a counter decremented by the tasks we wait for.
+         */
+        void wait(const std::atomic<size_t>& remaining)
+        {
+            while(remaining.load(std::memory_order_acquire) > 0)
+            {
+                if(!run_pending())
+                    std::this_thread::yield();
+            }
+        }
+
+        /**
+         * Run one of the queued tasks on the calling thread if any. A worker
+         * of this pool looks into its own queue first, then it tries to steal
+         * from the rest of the queues.
+         *
+         * @returns true if a task was run, false if every queue was empty.
+         */
+        bool run_pending()
+        {
+            const size_t first = (current_pool() == this) ? current_index() : 0;
+
+            std::function<void()> task{};
+
+            for(size_t i = 0; i < queues_.size() && !task; ++i)
+            {
+                Queue& queue = *queues_[(first + i) % queues_.size()];
+
+                std::lock_guard<std::mutex> lock{queue.mutex};
+
+                if(queue.tasks.empty())
+                    continue;
+
+                // the owner takes the newest task, thieves the oldest one.
+                if(i == 0 && current_pool() == this)
+                {
+                    task = std::move(queue.tasks.back());
+                    queue.tasks.pop_back();
+                }
+                else
+                {
+                    task = std::move(queue.tasks.front());
+                    queue.tasks.pop_front();
+                }
+            }
+
+            if(!task)
+                return false;
+
+            pending_.fetch_sub(1, std::memory_order_acq_rel);
+
+            task();
+
+            return true;
+        }
+
+    private:
+
+        /**
+         * The queue of tasks of a worker.
+         */
+        struct Queue
+        {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        std::vector<std::thread> workers_;
+        std::vector<std::unique_ptr<Queue>> queues_;
+        std::atomic<size_t> pending_; // tasks queued but not taken yet.
+        std::atomic<size_t> next_;    // round-robin queue for external submissions.
+        std::mutex mutex_;
+        std::condition_variable condition_;
+        bool stop_;
+
+        /**
+         * Get the pool the calling thread works for (if any).
+         */
+        static ThreadPool*& current_pool() noexcept
+        {
+            static thread_local ThreadPool* pool = nullptr;
+
+            return pool;
+        }
+
+        /**
+         * Get the index of the worker of the calling thread.
+         */
+        static size_t& current_index() noexcept
+        {
+            static thread_local size_t index = 0;
+
+            return index;
+        }
+
+        /**
+         * Main loop of the worker threads.
+         *
+         * @param index the index of the worker (and its queue).
+         */
+        void work(const size_t index)
+        {
+            current_pool() = this;
+            current_index() = index;
+
+            while(true)
+            {
+                if(run_pending())
+                    continue;
+
+                std::unique_lock<std::mutex> lock{mutex_};
+
+                condition_.wait(lock, [this]
+                {
+                    return stop_ || pending_.load(std::memory_order_acquire) > 0;
+                });
+
+                if(stop_ && pending_.load(std::memory_order_acquire) == 0)
+                    return;
+            }
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef TYPE_INDEX_H
+#define TYPE_INDEX_H
+
+#include <atomic>
+#include <type_traits>
+
+#include "config.h"
+
+namespace entis
+{
+    namespace detail
+    {
+        struct ComponentFamily;
+        struct GroupFamily;
+        struct QueryFamily;
+    }
+
+    /**
+     * Assigns a dense integer identifier (0, 1, 2, etc.) to every type
+     * it is queried with.
+     *
+     * The identifier of a type is generated the first time it is requested
+     * and stays the same for the rest of the program so, it can be used to
+     * index flat arrays instead of hashing the name of the type.
+     *
+     * Every Family has its own counter so the identifiers of a family stay
+     * dense no matter how many types of other families are indexed (e.g.
+     * groups and cached queries don't use up component identifiers).
+     *
+     * @tparam Family a tag type that selects the counter.
+     */
+    template <typename Family>
+    class BasicTypeIndex
+    {
+    public:
+        /**
+         * Get the identifier of the type T.
+         *
+         * cv-qualifiers and references are ignored so T, const T and T&
+         * share the same identifier.
+         *
+         * @tparam T the type whose identifier we want.
+         *
+         * @returns the dense identifier of the type T.
+         */
+        template <typename T>
+        static id_t get() noexcept
+        {
+            return index<std::remove_cv_t<std::remove_reference_t<T>>>();
+        }
+
+    private:
+
+        /**
+         * Generate the identifier of a type (only called once per type).
+         *
+         * @returns the next available identifier.
+         */
+        static id_t next() noexcept
+        {
+            static std::atomic<id_t> counter{0};
+
+            return counter.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        template <typename T>
+        static id_t index() noexcept
+        {
+            static const id_t value = next();
+
+            return value;
+        }
+    };
+
+    /**
+     * Identifiers of the component types (see Signature and MAX_COMPONENTS).
+     */
+    using TypeIndex = BasicTypeIndex<detail::ComponentFamily>;
+}
+
+#endif
@@ -2,6 +2,7 @@
 #define TYPE_LIST_H
 
 #include <utility>
+#include <type_traits>
 
 namespace entis
 {
@@ -382,6 +383,124 @@ namespace entis
          */
         template <typename List, template<typename T> class MetaFun>
         using transform = typename transform_t<List, MetaFun>::Type;
+
+
+        template <typename List, template<typename T> class Predicate, bool Empty = is_empty<List>::value>
+        class filter_t;
+
+        template <typename List, template<typename T> class Predicate>
+        class filter_t<List, Predicate, false>
+        {
+            using Tail = typename filter_t<pop_front<List>, Predicate>::Type;
+
+        public:
+            using Type = std::conditional_t<Predicate<front<List>>::value, push_front<Tail, front<List>>, Tail>;
+        };
+
+        template <typename List, template<typename T> class Predicate>
+        class filter_t<List, Predicate, true>
+        {
+        public:
+            using Type = List;
+        };
+
+        /**
+         * Keep the types of a type_list_t that satisfy a Predicate.
+         * 
+         * @tparam List a type_list_t.
+         * @tparam Predicate a type trait with a boolean value member
+         * (e.g. std::is_integral).
+         * 
+         * @return a new type_list_t with the types whose Predicate is true,
+         * in the same order (e.g. <int, float, char>, std::is_integral -> <int, char>).
+         */
+        template <typename List, template<typename T> class Predicate>
+        using filter = typename filter_t<List, Predicate>::Type;
+
+
+        template <typename List, typename T>
+        class contains_t;
+
+        template <typename... List, typename T>
+        class contains_t<type_list_t<List...>, T>
+        {
+        public:
+            static constexpr bool value = (std::is_same_v<List, T> || ...);
+        };
+
+        /**
+         * Check if a type_list_t has a type.
+         * 
+         * @tparam List a type_list_t.
+         * @tparam T the type we look for.
+         * 
+         * @return true if T is on the List (e.g. <int, float>, float -> true).
+         */
+        template <typename List, typename T>
+        inline constexpr bool contains = contains_t<List, T>::value;
+
+
+        template <typename List, typename Result = type_list_t<>>
+        class unique_t;
+
+        template <typename Result>
+        class unique_t<type_list_t<>, Result>
+        {
+        public:
+            using Type = Result;
+        };
+
+        template <typename Head, typename... Tail, typename Result>
+        class unique_t<type_list_t<Head, Tail...>, Result>
+        {
+            using Next = std::conditional_t<contains<Result, Head>, Result, push_back<Result, Head>>;
+
+        public:
+            using Type = typename unique_t<type_list_t<Tail...>, Next>::Type;
+        };
+
+        /**
+         * Remove the repeated types of a type_list_t.
+         * 
+         * @tparam List a type_list_t.
+         * 
+         * @return a new type_list_t with the first occurrence of every type,
+         * in the same order (e.g. <int, float, int> -> <int, float>).
+         */
+        template <typename List>
+        using unique = typename unique_t<List>::Type;
+
+        /**
+         * Check if every type of a type_list_t appears once.
+         * 
+         * @tparam List a type_list_t.
+         * 
+         * @return true if the List has no repeated types.
+         */
+        template <typename List>
+        inline constexpr bool is_unique = size<unique<List>>() == size<List>();
+
+
+        template <typename List, typename Other>
+        class is_disjoint_t;
+
+        template <typename... List, typename Other>
+        class is_disjoint_t<type_list_t<List...>, Other>
+        {
+        public:
+            static constexpr bool value = !(contains<Other, List> || ...);
+        };
+
+        /**
+         * Check if two type_list_t don't share any type.
+         * 
+         * @tparam List the first type_list_t.
+         * @tparam Other the second type_list_t.
+         * 
+         * @return true if no type is on both lists (e.g. <int>, <float> -> true).
+         */
+        template <typename List, typename Other>
+        inline constexpr bool is_disjoint = is_disjoint_t<List, Other>::value;
     }
 }
 
@@ -5,8 +5,11 @@
 #include <memory>
 #include <utility>
 #include <optional>
+#include <type_traits>
 
 #include "type_list.h"
+#include "soa.h"
+#include "tag_set.h"
 #include "sparse_set.h"
 #include "error.h"
 
@@ -18,12 +21,24 @@ namespace entis
     using BindResult = std::optional<error::BindError>;
 
     /**
-     * A pointer to a SparseSet that manages the type T.
+     * The container that stores the components of type T: a SoASet when
+     * T declares its fields on soa_traits, a TagSet when T is an empty type
+     * and a SparseSet otherwise.
      * 
-     * @tparam T the type that the SparseSet is managing.
+     * @tparam T the type of the component.
+     */
+    template <typename T>
+    using Storage = std::conditional_t<is_soa_v<T>, SoASet<T>, 
+                                       std::conditional_t<is_tag_v<T>, TagSet<T>, SparseSet<T>>>;
+
+    /**
+     * A non-owning pointer to the container that manages the type T (the
+     * Registry owns the managers).
+     * 
+     * @tparam T the type that the container is managing.
      */
     template <typename T>
-    using ComponentManager = std::shared_ptr<SparseSet<T>>;
+    using ComponentManager = Storage<T>*;
 
     /**
      * An optional that could contain a reference to the specified
@@ -34,6 +49,15 @@ namespace entis
     template <typename T>
     using Component = std::optional<std::reference_wrapper<const T>>;
 
+    /**
+     * An optional that could contain a mutable reference to the 
+     * specified type T.
+     * 
+     * @tparam T the type of the component.
+     */
+    template <typename T>
+    using MutableComponent = std::optional<std::reference_wrapper<T>>;
+
     /**
      * A tuple containig optionals to references to the types specified on a
      * type_list_t.
@@ -45,14 +69,37 @@ namespace entis
                                         typing::transform<List, typing::add_reference_wrapper>, 
                                         typing::add_optional>, 
                                     std::tuple>;
+    /**
+     * Type trait that is true for components that views and queries yield by
+     * reference: neither tags (no data) nor SoA components (their values are
+     * split across field arrays, see View::field).
+     * 
+     * @tparam T the type of the component.
+     */
+    template <typename T>
+    struct is_data_component : std::negation<std::disjunction<is_tag<T>, is_soa<T>>>
+    {
+    };
+
+    /**
+     * The types of a type_list_t that are yielded by reference, this is,
+     * without the tags (which are only used to filter entities) nor the SoA
+     * components (reached through their fields).
+     * 
+     * @tparam List a type_list_t declaration.
+     */
+    template <typename List>
+    using DataComponents = typing::filter<List, is_data_component>;
+
     /**
      * A tuple containig references to the types specified on a
-     * type_list_t if any.
+     * type_list_t if any (tags are filters only thus, they aren't
+     * part of the tuple).
      * 
      * @tparam List a type_list_t declaration containing the types that we want.
      */ 
     template <typename List>
-    using QueryResult = std::vector<typing::cast<typing::transform<List, typing::add_reference_wrapper>, std::tuple>>;
+    using QueryResult = std::vector<typing::cast<typing::transform<DataComponents<List>, typing::add_reference_wrapper>, std::tuple>>;
 }
 
 #endif
\ No newline at end of file
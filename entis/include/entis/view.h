@@ -0,0 +1,482 @@
+#ifndef VIEW_H
+#define VIEW_H
+
+#include <tuple>
+#include <vector>
+#include <cstddef>
+#include <utility>
+#include <iterator>
+#include <type_traits>
+
+#include "stats.h"
+#include "types.h"
+#include "config.h"
+#include "entity.h"
+#include "signature.h"
+#include "type_list.h"
+#include "thread_pool.h"
+
+namespace entis
+{
+    /**
+     * Empty type used to specify the components that the entities of a
+     * View mustn't have (e.g. registry.view<Position>(exclude<Dead>)).
+     *
+     * @tparam Types the types of the excluded components.
+     */
+    template <typename... Types>
+    struct exclude_t
+    {
+    };
+
+    /**
+     * Instance of exclude_t used when creating views.
+     *
+     * @tparam Types the types of the excluded components.
+     */
+    template <typename... Types>
+    inline constexpr exclude_t<Types...> exclude{};
+
+    namespace detail
+    {
+        /**
+         * Check if a function can be called with the elements of a tuple.
+         */
+        template <typename Fn, typename Tuple>
+        struct is_applicable;
+
+        template <typename Fn, typename... Types>
+        struct is_applicable<Fn, std::tuple<Types...>> : std::is_invocable<Fn, Types...>
+        {
+        };
+    }
+
+    /**
+     * A lightweight, non-owning and non-allocating range over the entities
+     * that have all the components on With and none of the components on
+     * Without.
+     *
+     * A view doesn't store the result of the query, it walks the packed
+     * array of keys of the smallest With manager and tests the rest of the
+     * managers for each key (which also skips the holes of managers with
+     * in_place_delete). Because of this, creating a view is cheap and
+     * it can be created every frame.
+     *
+     * Views created by a Registry test the rest of the components with the
+     * signature of each entity (a single AND/compare) instead of probing the
+     * sparse array of every manager.
+     *
+     * Tags (empty components) on With are filters only: they aren't part of
+     * the tuples yielded by the view nor are passed to each. SoA components
+     * aren't either since their values are split across field arrays, the
+     * view yields those arrays and the position of each entity on them:
+     * 
+     * auto view = registry.view<Particle, Emitter>();
+     * auto life = view.field<Particle, 2>();
+     * 
+     * view.each([&](id_t entity, Emitter& emitter){ life[view.index<Particle>(entity)] -= emitter.rate; });
+     *
+     * @tparam With a type_list_t declaration of the components the entities
+     * must have.
+     * @tparam Without a type_list_t declaration of the components the entities
+     * mustn't have.
+     */
+    template <typename With, typename Without>
+    class View;
+
+    /**
+     * Specialization used to convert the type_list_t declarations into
+     * parameter packs.
+     *
+     * @tparam With parameter pack with the components the entities must have.
+     * @tparam Without parameter pack with the components the entities mustn't have.
+     */
+    template <typename... With, typename... Without>
+    class View<typing::type_list_t<With...>, typing::type_list_t<Without...>>
+    {
+        static_assert(sizeof...(With) > 0, "a view must have at least one component");
+
+        static_assert(typing::is_unique<typing::type_list_t<With...>>, "a view can't require the same component twice");
+
+        static_assert(typing::is_unique<typing::type_list_t<Without...>>, "a view can't exclude the same component twice");
+
+        static_assert(typing::is_disjoint<typing::type_list_t<With...>, typing::type_list_t<Without...>>,
+                      "a view can't require and exclude the same component (it would always be empty)");
+
+    public:
+
+        /// The entity followed by references to its components (tags excluded).
+        using Entry = typing::cast<typing::push_front<
+            typing::transform<DataComponents<typing::type_list_t<With...>>, std::add_lvalue_reference_t>, id_t>, std::tuple>;
+
+        /// References to the components of an entity (tags excluded).
+        using Components = typing::cast<
+            typing::transform<DataComponents<typing::type_list_t<With...>>, std::add_lvalue_reference_t>, std::tuple>;
+
+        /**
+         * Forward iterator over the entities of a view. Dereferencing it yields
+         * a tuple with the entity and references to its components so it can be
+         * used with structured bindings (e.g. for(auto [entity, a, b] : view)).
+         */
+        class iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Entry;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = value_type;
+
+            iterator() = default;
+
+            iterator(const View* view, const id_t* current, const id_t* last)
+            : view_{view},
+              current_{current},
+              last_{last}
+            {
+                skip();
+            }
+
+            inline reference operator*() const
+            {
+                return view_->get(*current_);
+            }
+
+            inline iterator& operator++()
+            {
+                ++current_;
+                skip();
+
+                return *this;
+            }
+
+            inline iterator operator++(int)
+            {
+                iterator previous = *this;
+                ++(*this);
+
+                return previous;
+            }
+
+            inline bool operator==(const iterator& other) const noexcept
+            {
+                return current_ == other.current_;
+            }
+
+            inline bool operator!=(const iterator& other) const noexcept
+            {
+                return current_ != other.current_;
+            }
+
+        private:
+
+            const View* view_ = nullptr;
+            const id_t* current_ = nullptr;
+            const id_t* last_ = nullptr;
+
+            /**
+             * Advance until an entity that satisfies the view is found.
+             */
+            inline void skip()
+            {
+                while(current_ != last_ && !view_->matches(*current_))
+                    ++current_;
+            }
+        };
+
+        /**
+         * Create a view over the specified managers.
+         *
+         * @param with the managers of the components the entities must have
+         * (a nullptr means that the manager doesn't exist thus the view is empty).
+         * @param without the managers of the components the entities mustn't have
+         * (a nullptr means that the manager doesn't exist thus it's ignored).
+         * @param signatures the signatures of the entities indexed by to_index
+         * (a nullptr means that the managers are probed instead), they must be
+         * kept up to date with the managers.
+         */
+        View(const std::tuple<Storage<With>*...> with, const std::tuple<Storage<Without>*...> without,
+             const std::pmr::vector<Signature>* signatures = nullptr)
+        : with_{with},
+          without_{without},
+          driver_{nullptr},
+          signatures_{signatures},
+          with_mask_{signatures ? Signature::of<With...>() : Signature{}},
+          without_mask_{signatures ? Signature::of<Without...>() : Signature{}}
+        {
+            if((std::get<Storage<With>*>(with_) && ...))
+            {
+                ((driver_ = (!driver_ || std::get<Storage<With>*>(with_)->keys().size() < driver_->size())
+                    ? &std::get<Storage<With>*>(with_)->keys() : driver_), ...);
+            }
+        }
+
+        /**
+         * Get an iterator to the first entity of the view.
+         */
+        iterator begin() const
+        {
+            return driver_ ? iterator{this, driver_->data(), driver_->data() + driver_->size()} : iterator{};
+        }
+
+        /**
+         * Get an iterator past the last entity of the view.
+         */
+        iterator end() const
+        {
+            return driver_ ? iterator{this, driver_->data() + driver_->size(), driver_->data() + driver_->size()} : iterator{};
+        }
+
+        /**
+         * Get an upper bound of the number of entities on the view.
+         *
+         * @returns the number of keys of the smallest With manager.
+         */
+        inline size_t size_hint() const noexcept
+        {
+            return driver_ ? driver_->size() : 0;
+        }
+
+        /**
+         * Check if an entity satisfies the view.
+         *
+         * @param entity the entity we want to test.
+         *
+         * @returns true if it has all the With components and none
+         * of the Without components, false otherwise.
+         */
+        inline bool contains(const id_t entity) const noexcept
+        {
+            return driver_ &&
+                   (std::get<Storage<With>*>(with_)->has_data(entity) && ...) &&
+                  !((std::get<Storage<Without>*>(without_) &&
+                     std::get<Storage<Without>*>(without_)->has_data(entity)) || ...);
+        }
+
+        /**
+         * Get the components of an entity that satisfies the view.
+         *
+         * @param entity an entity of the view (e.g. contains(entity) yields true).
+         *
+         * @returns a tuple with the entity and references to its components
+         * (tags excluded).
+         */
+        inline Entry get(const id_t entity) const noexcept
+        {
+            return std::tuple_cat(std::tuple<id_t>{entity}, component<With>(entity)...);
+        }
+
+        /**
+         * Get the components of an entity that satisfies the view.
+         *
+         * @param entity an entity of the view (e.g. contains(entity) yields true).
+         *
+         * @returns a tuple with references to its components (tags excluded).
+         */
+        inline Components components(const id_t entity) const noexcept
+        {
+            return std::tuple_cat(component<With>(entity)...);
+        }
+
+        /**
+         * Apply a function to all the entities of the view.
+         *
+         * @tparam Fn a callable with the signature fn(id_t, With&...) or
+         * fn(With&...) (without the tags).
+         *
+         * @param fn the function to apply.
+         */
+        template <typename Fn>
+        void each(Fn&& fn) const
+        {
+            if(!driver_)
+                return;
+
+            ENTIS_STATS(detail::QueryScope scope{detail::query_stats_of<View>(), driver_->size()};)
+            ENTIS_STATS(uint64_t matched = 0;)
+
+            for(const id_t entity : *driver_)
+            {
+                if(matches(entity))
+                {
+                    ENTIS_STATS(++matched;)
+
+                    invoke(fn, entity);
+                }
+            }
+
+            ENTIS_STATS(scope.matched.fetch_add(matched, std::memory_order_relaxed);)
+        }
+
+        /**
+         * Apply a function to all the entities of the view in parallel. The packed
+         * array of keys of the smallest manager is split in chunks that are run on
+         * the workers of the pool, thus every invocation gets references to the
+         * components of a different entity. The call returns once every entity 
+         * was visited.
+         * 
+         * While the iteration is running it's safe to:
+         * + Read and modify the components passed to fn (they belong to a single entity).
+         * + Read components of other entities (get_component, has_component or views) 
+         *   as long as no one else modifies them.
+         * 
+         * It's NOT safe to change the structure of the registry (make_entity, kill_entity,
+         * bind, unbind, group or creating a new manager) since that could move or 
+         * reallocate the packed arrays, record those changes and apply them afterwards.
+         *
+         * @tparam Fn a callable with the signature fn(id_t, With&...) or
+         * fn(With&...) (without the tags).
+         *
+         * @param pool the pool whose workers will run the chunks.
+         * @param fn the function to apply (it must be safe to call it concurrently).
+         * @param grain the number of keys per chunk (0 splits the keys in about four
+         * chunks per worker).
+         */
+        template <typename Fn>
+        void each_par(ThreadPool& pool, Fn&& fn, const size_t grain = 0) const
+        {
+            if(!driver_ || driver_->empty())
+                return;
+
+            const size_t count = driver_->size();
+            const size_t chunk = grain ? grain : count / (pool.size() * 4) + 1;
+
+            ENTIS_STATS(detail::QueryScope scope{detail::query_stats_of<View>(), count};)
+
+            pool.parallel_for(count, chunk, [&](const size_t begin, const size_t end)
+            {
+                const id_t* entities = driver_->data();
+
+                ENTIS_STATS(uint64_t matched = 0;)
+
+                for(size_t i = begin; i < end; ++i)
+                {
+                    const id_t entity = entities[i];
+
+                    if(matches(entity))
+                    {
+                        ENTIS_STATS(++matched;)
+
+                        invoke(fn, entity);
+                    }
+                }
+
+                ENTIS_STATS(scope.matched.fetch_add(matched, std::memory_order_relaxed);)
+            });
+        }
+
+        /**
+         * Get the manager of a component of the view.
+         *
+         * @tparam T a component on With or Without.
+         *
+         * @returns a pointer to the manager or nullptr if it doesn't exist.
+         */
+        template <typename T>
+        inline Storage<T>* storage() const noexcept
+        {
+            static_assert(typing::contains<typing::type_list_t<With..., Without...>, T>,
+                          "the component isn't part of the view");
+
+            if constexpr(typing::contains<typing::type_list_t<With...>, T>)
+                return std::get<Storage<T>*>(with_);
+            else
+                return std::get<Storage<T>*>(without_);
+        }
+
+        /**
+         * Get the values of the I-th field of a SoA component of the view
+         * (see SoASet::field), to be indexed with index<T>(entity).
+         *
+         * @tparam T a SoA component on With.
+         * @tparam I the index of the field.
+         *
+         * @returns a span over the field of every key of the manager (empty
+         * if the manager doesn't exist).
+         */
+        template <typename T, size_t I>
+        inline auto field() const noexcept
+        {
+            static_assert(is_soa_v<T> && typing::contains<typing::type_list_t<With...>, T>,
+                          "only the SoA components the entities must have have fields");
+
+            using Span = decltype(std::declval<Storage<T>&>().template field<I>());
+
+            Storage<T>* manager = std::get<Storage<T>*>(with_);
+
+            return manager ? manager->template field<I>() : Span{nullptr, 0};
+        }
+
+        /**
+         * Get the position of an entity of the view on the packed arrays of
+         * one of its components, e.g. on the field arrays of a SoA component.
+         *
+         * @tparam T a component on With.
+         *
+         * @param entity an entity of the view (e.g. contains(entity) yields true).
+         *
+         * @returns the position of the entity on the manager of T.
+         */
+        template <typename T>
+        inline size_t index(const id_t entity) const noexcept
+        {
+            static_assert(typing::contains<typing::type_list_t<With...>, T>,
+                          "the entities of the view don't have the component");
+
+            return std::get<Storage<T>*>(with_)->index(entity);
+        }
+
+    private:
+
+        std::tuple<Storage<With>*...> with_;
+        std::tuple<Storage<Without>*...> without_;
+        const std::pmr::vector<id_t>* driver_; // keys of the smallest With manager.
+        const std::pmr::vector<Signature>* signatures_;
+        Signature with_mask_;
+        Signature without_mask_;
+
+        /**
+         * Check if a key of the driver satisfies the view. Unlike contains, 
+         * the entity must be a key of the driver (e.g. it can't be a stale 
+         * handle) when the signatures are used.
+         */
+        inline bool matches(const id_t entity) const noexcept
+        {
+            if(!signatures_)
+                return contains(entity);
+
+            // tombstones (MAX_ID) are out of range.
+            const id_t index = to_index(entity);
+
+            return index < signatures_->size() && (*signatures_)[index].matches(with_mask_, without_mask_);
+        }
+
+        /**
+         * Get a tuple with a reference to the component W of an entity or
+         * an empty tuple when W is a tag.
+         */
+        template <typename W>
+        inline auto component(const id_t entity) const noexcept
+        {
+            if constexpr(!is_data_component<W>::value)
+                return std::tuple<>{};
+            else
+                return std::tuple<W&>{ std::get<Storage<W>*>(with_)->get(entity) };
+        }
+
+        /**
+         * Call fn with the components of an entity (and the entity itself
+         * if fn takes it).
+         */
+        template <typename Fn>
+        inline void invoke(Fn& fn, const id_t entity) const
+        {
+            if constexpr(detail::is_applicable<Fn&, Entry>::value)
+                std::apply(fn, get(entity));
+            else
+                std::apply(fn, components(entity));
+        }
+    };
+}
+
+#endif
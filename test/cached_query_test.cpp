@@ -0,0 +1,142 @@
+#include <tuple>
+#include <vector>
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+#include <entis/registry.h>
+#include <entis/cached_query.h>
+
+// Utily structs used for testing purposes.
+
+struct Cargo
+{
+    Cargo(const int weight)
+    : weight{weight}
+    {
+
+    }
+
+    int weight;
+};
+
+struct Fuel
+{
+    Fuel(const float liters)
+    : liters{liters}
+    {
+
+    }
+
+    float liters;
+};
+
+struct Docked
+{
+};
+
+template <typename Entities>
+static std::vector<entis::id_t> sorted(const Entities& entities)
+{
+    std::vector<entis::id_t> result(entities.begin(), entities.end());
+
+    std::sort(result.begin(), result.end());
+
+    return result;
+}
+
+TEST(CachedQueryTest, FindsExistingEntities)
+{
+    entis::Registry registry{};
+
+    const entis::id_t e0 = registry.make_entity();
+    const entis::id_t e1 = registry.make_entity();
+    const entis::id_t e2 = registry.make_entity();
+
+    registry.bind<Cargo>(e0, 1);
+    registry.bind<Fuel>(e0, 1.0f);
+    registry.bind<Cargo>(e1, 2);
+    registry.bind<Cargo>(e2, 3);
+    registry.bind<Fuel>(e2, 3.0f);
+    registry.bind<Docked>(e2);
+
+    auto& query = registry.cached_query<Cargo, Fuel>(entis::exclude<Docked>);
+
+    ASSERT_EQ(query.entities(), (std::pmr::vector<entis::id_t>{e0}));
+    ASSERT_EQ(&query, (&registry.cached_query<Cargo, Fuel>(entis::exclude<Docked>)));
+    ASSERT_EQ(&query, (&registry.cached_query<Cargo, Fuel>(entis::exclude<Docked, Docked>)));
+
+    int weight = 0;
+
+    query.each([&weight](Cargo& cargo, const Fuel&)
+    {
+        weight += cargo.weight;
+    });
+
+    ASSERT_EQ(weight, 1);
+    ASSERT_EQ(std::get<1>(query.get(e0)).weight, 1);
+}
+
+TEST(CachedQueryTest, IsUpdatedIncrementally)
+{
+    entis::Registry registry{};
+
+    auto& query = registry.cached_query<Cargo, Fuel>(entis::exclude<Docked>);
+
+    ASSERT_EQ(query.size(), 0);
+
+    std::vector<entis::id_t> entities(5);
+
+    registry.create(entities.size(), entities.begin());
+
+    for(const entis::id_t entity : entities)
+    {
+        registry.bind<Cargo>(entity, 1);
+        registry.bind<Fuel>(entity, 1.0f);
+    }
+
+    ASSERT_EQ(sorted(query.entities()), sorted(entities));
+
+    registry.bind<Docked>(entities[0]);
+    registry.unbind<Fuel>(entities[1]);
+    registry.erase<Cargo>(entities[2]);
+    registry.kill_entity(entities[3]);
+
+    ASSERT_EQ(query.entities(), (std::pmr::vector<entis::id_t>{entities[4]}));
+
+    // replacing a component doesn't duplicate the entity.
+    registry.bind<Cargo>(entities[4], 2);
+
+    ASSERT_EQ(query.size(), 1);
+
+    registry.unbind<Docked>(entities[0]);
+    registry.bind<Fuel>(entities[1], 2.0f);
+
+    ASSERT_EQ(sorted(query.entities()), sorted(std::vector<entis::id_t>{entities[0], entities[1], entities[4]}));
+    ASSERT_FALSE(query.contains(entities[3]));
+
+    // a recycled entity starts without components.
+    const entis::id_t recycled = registry.make_entity();
+
+    ASSERT_FALSE(query.contains(recycled));
+
+    registry.bind<Cargo>(recycled, 3);
+    registry.bind<Fuel>(recycled, 3.0f);
+
+    ASSERT_TRUE(query.contains(recycled));
+    ASSERT_EQ(query.size(), 4);
+}
+
+TEST(CachedQueryTest, ExistingQueryIsFoundOnReadPhases)
+{
+    entis::Registry registry{};
+
+    auto& query = registry.cached_query<Cargo, Fuel>();
+
+    // looking up an existing query doesn't change the registry.
+    registry.freeze();
+
+    ASSERT_EQ((&registry.cached_query<Cargo, Fuel>()), &query);
+
+    registry.thaw();
+}
@@ -0,0 +1,181 @@
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <entis/registry.h>
+#include <entis/thread_pool.h>
+#include <entis/command_buffer.h>
+
+// Utily structs used for testing purposes.
+
+struct Name
+{
+    Name(const std::string& value)
+    : value{value}
+    {
+
+    }
+
+    std::string value;
+};
+
+struct Lifetime
+{
+    Lifetime(const int frames)
+    : frames{frames}
+    {
+
+    }
+
+    int frames;
+};
+
+struct Waypoint
+{
+    float x;
+    float y;
+};
+
+TEST(CommandBufferTest, AppliesCommandsOnFlush)
+{
+    entis::Registry registry{};
+    entis::CommandBuffer buffer{};
+
+    const entis::id_t e0 = registry.make_entity();
+    const entis::id_t e1 = registry.make_entity();
+
+    registry.bind<Lifetime>(e0, 0);
+    registry.bind<Lifetime>(e1, 5);
+
+    ASSERT_TRUE(buffer.empty());
+
+    // kill the expired entities while iterating.
+    registry.view<Lifetime>().each([&buffer](const entis::id_t entity, Lifetime& lifetime)
+    {
+        if(lifetime.frames == 0)
+            buffer.kill_entity(entity);
+        else
+            buffer.bind<Name>(entity, std::string{"alive"});
+    });
+
+    const entis::CommandBuffer::Spawned spawned = buffer.make_entity();
+
+    buffer.bind<Lifetime>(spawned, 10);
+    buffer.bind<Name>(spawned, std::string{"spawned"});
+    buffer.unbind<Lifetime>(e1);
+
+    ASSERT_FALSE(buffer.empty());
+    ASSERT_TRUE(registry.is_alive(e0));
+
+    registry.flush(buffer);
+
+    ASSERT_TRUE(buffer.empty());
+
+    ASSERT_FALSE(registry.is_alive(e0));
+    ASSERT_FALSE(registry.has_component<Lifetime>(e1));
+    ASSERT_EQ(registry.get_component<Name>(e1).value().get().value, "alive");
+
+    // the spawned entity recycles e0.
+    const entis::id_t created = registry.entities_with_component<Name>().back();
+
+    ASSERT_EQ(registry.get_component<Name>(created).value().get().value, "spawned");
+    ASSERT_EQ(registry.get_component<Lifetime>(created).value().get().frames, 10);
+}
+
+TEST(CommandBufferTest, CanRecordFromWorkerThreads)
+{
+    entis::Registry registry{};
+    entis::ThreadPool pool{4};
+
+    for(int i = 0; i < 256; ++i)
+        registry.bind<Lifetime>(registry.make_entity(), i % 2);
+
+    std::vector<entis::CommandBuffer> buffers(8);
+
+    // one buffer per chunk so no two threads share a buffer.
+    pool.parallel_for(256, 32, [&registry, &buffers](const size_t begin, const size_t end)
+    {
+        entis::CommandBuffer& buffer = buffers[begin / 32];
+
+        for(size_t i = begin; i < end; ++i)
+        {
+            const entis::id_t entity = registry.storage<Lifetime>()->keys()[i];
+
+            if(registry.get_component<Lifetime>(entity).value().get().frames == 0)
+                buffer.kill_entity(entity);
+        }
+    });
+
+    for(entis::CommandBuffer& buffer : buffers)
+        registry.flush(buffer);
+
+    ASSERT_EQ(registry.entities_with_component<Lifetime>().size(), 128);
+}
+
+TEST(CommandBufferTest, KillsAreAppliedLast)
+{
+    entis::Registry registry{};
+    entis::CommandBuffer buffer{};
+
+    const entis::id_t killed = registry.make_entity();
+
+    registry.bind<Lifetime>(killed, 1);
+
+    // recorded in this order, applied as spawn, bind and kill.
+    buffer.kill_entity(killed);
+
+    const entis::CommandBuffer::Spawned spawned = buffer.make_entity();
+
+    buffer.bind<Lifetime>(spawned, 2);
+    buffer.bind<Lifetime>(killed, 3);
+    buffer.unbind<Lifetime>(killed);
+    buffer.bind<Name>(killed, "ghost");
+
+    registry.flush(buffer);
+
+    ASSERT_FALSE(registry.is_alive(killed));
+
+    // the spawned entity doesn't recycle the index of the killed one.
+    std::vector<entis::id_t> alive{};
+
+    registry.view<Lifetime>().each([&alive](const entis::id_t entity, Lifetime& lifetime)
+    {
+        ASSERT_EQ(lifetime.frames, 2);
+
+        alive.push_back(entity);
+    });
+
+    ASSERT_EQ(alive.size(), 1);
+    ASSERT_NE(entis::to_index(alive[0]), entis::to_index(killed));
+    ASSERT_EQ(registry.storage<Name>()->size(), 0);
+}
+
+TEST(CommandBufferTest, BindsAggregates)
+{
+    entis::Registry registry{};
+    entis::CommandBuffer buffer{};
+
+    const entis::id_t entity = registry.make_entity();
+    const entis::CommandBuffer::Spawned spawned = buffer.make_entity();
+
+    // brace-initialized like a direct bind.
+    buffer.bind<Waypoint>(entity, 1.0f, 2.0f);
+    buffer.bind<Waypoint>(spawned, 3.0f, 4.0f);
+
+    registry.flush(buffer);
+
+    ASSERT_EQ(registry.get_component<Waypoint>(entity)->get().x, 1.0f);
+    ASSERT_EQ(registry.get_component<Waypoint>(entity)->get().y, 2.0f);
+
+    registry.view<Waypoint>().each([entity](const entis::id_t other, Waypoint& waypoint)
+    {
+        if(other != entity)
+        {
+            ASSERT_EQ(waypoint.x, 3.0f);
+            ASSERT_EQ(waypoint.y, 4.0f);
+        }
+    });
+
+    ASSERT_EQ(registry.storage<Waypoint>()->size(), 2);
+}
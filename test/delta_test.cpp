@@ -0,0 +1,394 @@
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+#include <entis/delta.h>
+#include <entis/registry.h>
+#include <entis/snapshot.h>
+
+// Utily structs used for testing purposes.
+
+struct Ammo
+{
+    int rounds;
+};
+
+struct Callsign
+{
+    std::string text;
+};
+
+struct Beacon
+{
+};
+
+static void write_callsign(entis::OutputArchive& archive, const Callsign& callsign)
+{
+    archive.write(static_cast<uint32_t>(callsign.text.size()));
+    archive.write(callsign.text.data(), callsign.text.size());
+}
+
+static Callsign read_callsign(entis::InputArchive& archive)
+{
+    uint32_t size = 0;
+
+    archive.read(size);
+
+    const char* text = archive.block<char>(size);
+
+    return Callsign{text ? std::string{text, size} : std::string{}};
+}
+
+TEST(DeltaTest, RegistryPublishesLifecycleSignals)
+{
+    entis::Registry registry{};
+
+    std::vector<entis::id_t> created{};
+    std::vector<entis::id_t> killed{};
+
+    registry.on_create().connect([&created](entis::Registry&, const entis::id_t entity)
+    {
+        created.push_back(entity);
+    });
+
+    registry.on_kill().connect([&killed](entis::Registry& registry, const entis::id_t entity)
+    {
+        // published while the entity is still alive.
+        ASSERT_TRUE(registry.is_alive(entity));
+
+        killed.push_back(entity);
+    });
+
+    const entis::id_t first = registry.make_entity();
+
+    std::vector<entis::id_t> entities(3);
+
+    registry.create(entities.size(), entities.begin());
+    registry.kill_entity(first);
+
+    ASSERT_EQ(created, (std::vector<entis::id_t>{first, entities[0], entities[1], entities[2]}));
+    ASSERT_EQ(killed, std::vector<entis::id_t>{first});
+}
+
+TEST(DeltaTest, TrackersRecordLastChange)
+{
+    entis::Registry registry{};
+    entis::EntityTracker entities{registry};
+    entis::ComponentTracker<Ammo> ammo{registry};
+
+    const entis::id_t a = registry.make_entity();
+    const entis::id_t b = registry.make_entity();
+
+    registry.bind<Ammo>(a, 1);
+    registry.bind<Ammo>(b, 2);
+    registry.patch<Ammo>(a, [](Ammo& value) { ++value.rounds; });
+    registry.unbind<Ammo>(b);
+
+    ASSERT_EQ(entities.events().size(), 2u);
+    ASSERT_EQ(ammo.changed().size(), 1u);
+    ASSERT_EQ(ammo.changed()[0], a);
+    ASSERT_EQ(ammo.destroyed().size(), 1u);
+    ASSERT_EQ(ammo.destroyed()[0], b);
+
+    registry.bind<Ammo>(b, 3);
+
+    ASSERT_EQ(ammo.changed().size(), 2u);
+    ASSERT_TRUE(ammo.destroyed().empty());
+
+    entities.clear();
+    ammo.clear();
+
+    ASSERT_TRUE(entities.events().empty());
+    ASSERT_TRUE(ammo.changed().empty());
+    ASSERT_TRUE(ammo.destroyed().empty());
+}
+
+TEST(DeltaTest, CanApplyDeltaOnBaseline)
+{
+    entis::Registry source{};
+
+    std::vector<entis::id_t> entities(8);
+
+    source.create(entities.size(), entities.begin());
+
+    for(size_t i = 0; i < entities.size(); ++i)
+    {
+        source.bind<Ammo>(entities[i], static_cast<int>(i));
+        source.bind<Callsign>(entities[i], std::string(i + 1, 'a'));
+
+        if(i % 2 == 0)
+            source.bind<Beacon>(entities[i]);
+    }
+
+    std::vector<std::byte> baseline{};
+    entis::OutputArchive baseline_output{baseline};
+
+    entis::Snapshot{source}
+        .entities(baseline_output)
+        .component<Ammo>(baseline_output)
+        .component<Callsign>(baseline_output, write_callsign)
+        .component<Beacon>(baseline_output);
+
+    entis::Registry target{};
+    entis::InputArchive baseline_input{baseline.data(), baseline.size()};
+    entis::SnapshotLoader baseline_loader{target};
+
+    ASSERT_FALSE(baseline_loader.entities(baseline_input).has_value());
+    ASSERT_FALSE(baseline_loader.component<Ammo>(baseline_input).has_value());
+    ASSERT_FALSE(baseline_loader.component<Callsign>(baseline_input, read_callsign).has_value());
+    ASSERT_FALSE(baseline_loader.component<Beacon>(baseline_input).has_value());
+
+    entis::EntityTracker lifecycle{source};
+    entis::ComponentTracker<Ammo> ammo{source};
+    entis::ComponentTracker<Callsign> callsigns{source};
+    entis::ComponentTracker<Beacon> beacons{source};
+
+    // the killed index is recycled by the next creation.
+    source.kill_entity(entities[3]);
+
+    const entis::id_t spawned = source.make_entity();
+    const entis::id_t fresh = source.make_entity();
+
+    source.bind<Ammo>(spawned, 42);
+    source.bind<Beacon>(fresh);
+    source.patch<Ammo>(entities[0], [](Ammo& value) { value.rounds = 100; });
+    source.bind<Callsign>(entities[1], "renamed");
+    source.unbind<Beacon>(entities[2]);
+    source.unbind<Ammo>(entities[4]);
+
+    std::vector<std::byte> buffer{};
+    entis::OutputArchive output{buffer};
+
+    entis::DeltaSnapshot{source}
+        .entities(output, lifecycle)
+        .component<Ammo>(output, ammo)
+        .component<Callsign>(output, callsigns, write_callsign)
+        .component<Beacon>(output, beacons);
+
+    // a delta only holds the changes.
+    ASSERT_LT(buffer.size(), baseline.size());
+
+    entis::InputArchive input{buffer.data(), buffer.size()};
+    entis::DeltaLoader loader{target};
+
+    ASSERT_FALSE(loader.entities(input).has_value());
+    ASSERT_FALSE(loader.component<Ammo>(input).has_value());
+    ASSERT_FALSE(loader.component<Callsign>(input, read_callsign).has_value());
+    ASSERT_FALSE(loader.component<Beacon>(input).has_value());
+    ASSERT_EQ(input.position(), buffer.size());
+
+    entities.push_back(spawned);
+    entities.push_back(fresh);
+
+    for(const entis::id_t entity : entities)
+    {
+        ASSERT_EQ(target.is_alive(entity), source.is_alive(entity));
+
+        if(!source.is_alive(entity))
+            continue;
+
+        ASSERT_EQ(target.signature(entity), source.signature(entity));
+
+        if(source.has_component<Ammo>(entity))
+        {
+            ASSERT_EQ(target.get_component<Ammo>(entity)->get().rounds, source.get_component<Ammo>(entity)->get().rounds);
+        }
+
+        if(source.has_component<Callsign>(entity))
+        {
+            ASSERT_EQ(target.get_component<Callsign>(entity)->get().text, source.get_component<Callsign>(entity)->get().text);
+        }
+    }
+
+    ASSERT_EQ(target.make_entity(), source.make_entity());
+}
+
+TEST(DeltaTest, RejectsDeltaOnWrongBaseline)
+{
+    entis::Registry source{};
+    entis::EntityTracker lifecycle{source};
+
+    source.make_entity();
+
+    std::vector<std::byte> buffer{};
+    entis::OutputArchive output{buffer};
+
+    entis::DeltaSnapshot{source}.entities(output, lifecycle);
+
+    {
+        // the target already has an entity thus, the creation gets another identifier.
+        entis::Registry target{};
+
+        target.make_entity();
+
+        entis::InputArchive input{buffer.data(), buffer.size()};
+
+        ASSERT_EQ(entis::DeltaLoader{target}.entities(input), entis::error::LoadError::BAD_FORMAT);
+    }
+
+    {
+        entis::Registry target{};
+        entis::InputArchive input{buffer.data(), buffer.size() - 1};
+
+        ASSERT_EQ(entis::DeltaLoader{target}.entities(input), entis::error::LoadError::TRUNCATED);
+    }
+}
+
+TEST(DeltaTest, RejectsKillingOfDeadEntity)
+{
+    entis::Registry source{};
+
+    const entis::id_t entity = source.make_entity();
+
+    entis::EntityTracker lifecycle{source};
+
+    source.kill_entity(entity);
+
+    std::vector<std::byte> buffer{};
+    entis::OutputArchive output{buffer};
+
+    entis::DeltaSnapshot{source}.entities(output, lifecycle);
+
+    // the target never had the entity.
+    entis::Registry target{};
+    entis::InputArchive input{buffer.data(), buffer.size()};
+
+    ASSERT_EQ(entis::DeltaLoader{target}.entities(input), entis::error::LoadError::BAD_FORMAT);
+}
+
+TEST(DeltaTest, ReplaysCompaction)
+{
+    entis::Registry source{};
+
+    std::vector<entis::id_t> entities(6);
+
+    source.create(entities.size(), entities.begin());
+
+    for(size_t i = 0; i < entities.size(); ++i)
+        source.bind<Ammo>(entities[i], static_cast<int>(i));
+
+    source.kill_entity(entities[1]);
+
+    std::vector<std::byte> baseline{};
+    entis::OutputArchive baseline_output{baseline};
+
+    entis::Snapshot{source}.entities(baseline_output).component<Ammo>(baseline_output);
+
+    entis::Registry target{};
+    entis::InputArchive baseline_input{baseline.data(), baseline.size()};
+    entis::SnapshotLoader baseline_loader{target};
+
+    ASSERT_FALSE(baseline_loader.entities(baseline_input).has_value());
+    ASSERT_FALSE(baseline_loader.component<Ammo>(baseline_input).has_value());
+
+    entis::EntityTracker lifecycle{source};
+    entis::ComponentTracker<Ammo> ammo{source};
+
+    source.kill_entity(entities[2]);
+    source.patch<Ammo>(entities[5], [](Ammo& value) { value.rounds = 50; });
+
+    source.compact();
+
+    // creations after the compaction recycle the lowest index on both sides.
+    const entis::id_t spawned = source.make_entity();
+
+    source.bind<Ammo>(spawned, 7);
+
+    // the tracked entity follows its new identifier.
+    ASSERT_EQ(ammo.changed().size(), 2);
+    ASSERT_TRUE(std::all_of(ammo.changed().begin(), ammo.changed().end(), [&source](const entis::id_t entity)
+    {
+        return source.is_alive(entity);
+    }));
+
+    std::vector<std::byte> buffer{};
+    entis::OutputArchive output{buffer};
+
+    entis::DeltaSnapshot{source}.entities(output, lifecycle).component<Ammo>(output, ammo);
+
+    entis::InputArchive input{buffer.data(), buffer.size()};
+    entis::DeltaLoader loader{target};
+
+    ASSERT_FALSE(loader.entities(input).has_value());
+    ASSERT_FALSE(loader.component<Ammo>(input).has_value());
+
+    source.view<Ammo>().each([&target](const entis::id_t entity, const Ammo& value)
+    {
+        ASSERT_TRUE(target.is_alive(entity));
+        ASSERT_EQ(target.get_component<Ammo>(entity)->get().rounds, value.rounds);
+    });
+
+    ASSERT_EQ(target.storage<Ammo>()->size(), source.storage<Ammo>()->size());
+    ASSERT_EQ(target.make_entity(), source.make_entity());
+}
+
+TEST(DeltaTest, RejectsComponentBlocksWithoutChanges)
+{
+    entis::Registry source{};
+
+    const entis::id_t first = source.make_entity();
+    const entis::id_t second = source.make_entity();
+
+    source.bind<Ammo>(first, 1);
+
+    entis::Registry target{};
+
+    target.make_entity();
+    target.make_entity();
+    target.bind<Ammo>(first, 1);
+
+    // the second entity is dead on the target.
+    target.kill_entity(second);
+
+    entis::ComponentTracker<Ammo> ammo{source};
+
+    source.patch<Ammo>(first, [](Ammo& value) { value.rounds = 10; });
+    source.bind<Ammo>(second, 20);
+
+    std::vector<std::byte> buffer{};
+    entis::OutputArchive output{buffer};
+
+    entis::DeltaSnapshot{source}.component<Ammo>(output, ammo);
+
+    entis::InputArchive input{buffer.data(), buffer.size()};
+
+    ASSERT_EQ(entis::DeltaLoader{target}.component<Ammo>(input), entis::error::LoadError::BAD_FORMAT);
+
+    // nothing was applied.
+    ASSERT_EQ(target.get_component<Ammo>(first)->get().rounds, 1);
+
+    // the same key twice.
+    std::vector<std::byte> repeated{};
+    entis::OutputArchive repeated_output{repeated};
+
+    const entis::id_t keys[] = {first, first};
+    const Ammo values[] = {{2}, {3}};
+
+    repeated_output.write(uint64_t{0});
+    repeated_output.write(uint64_t{2});
+    repeated_output.write(keys, 2);
+    repeated_output.write(values, 2);
+
+    entis::InputArchive repeated_input{repeated.data(), repeated.size()};
+
+    ASSERT_EQ(entis::DeltaLoader{target}.component<Ammo>(repeated_input), entis::error::LoadError::BAD_FORMAT);
+    ASSERT_EQ(target.get_component<Ammo>(first)->get().rounds, 1);
+
+    // a truncated block of values isn't applied either.
+    std::vector<std::byte> single{};
+    entis::OutputArchive single_output{single};
+
+    single_output.write(uint64_t{0});
+    single_output.write(uint64_t{1});
+    single_output.write(keys, 1);
+    single_output.write(values, 1);
+
+    entis::InputArchive truncated{single.data(), single.size() - 1};
+
+    ASSERT_EQ(entis::DeltaLoader{target}.component<Ammo>(truncated), entis::error::LoadError::TRUNCATED);
+    ASSERT_EQ(target.get_component<Ammo>(first)->get().rounds, 1);
+}
@@ -0,0 +1,116 @@
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+#include <entis/group.h>
+#include <entis/registry.h>
+
+// Utily structs used for testing purposes.
+
+struct Transform
+{
+    Transform(const int x)
+    : x{x}
+    {
+
+    }
+
+    int x;
+};
+
+struct Mesh
+{
+    Mesh(const std::string& name)
+    : name{name}
+    {
+
+    }
+
+    std::string name;
+};
+
+TEST(GroupTest, ArrangesExistingEntities)
+{
+    entis::Registry registry{};
+
+    const entis::id_t e0 = registry.make_entity();
+    const entis::id_t e1 = registry.make_entity();
+    const entis::id_t e2 = registry.make_entity();
+
+    registry.bind<Transform>(e0, 0);
+    registry.bind<Transform>(e1, 1);
+    registry.bind<Transform>(e2, 2);
+
+    registry.bind<Mesh>(e2, std::string{"e2"});
+    registry.bind<Mesh>(e0, std::string{"e0"});
+
+    entis::Group<Transform, Mesh> group = registry.group<Transform, Mesh>();
+
+    ASSERT_EQ(group.size(), 2);
+    ASSERT_TRUE(group.contains(e0));
+    ASSERT_FALSE(group.contains(e1));
+    ASSERT_TRUE(group.contains(e2));
+
+    std::vector<entis::id_t> visited{};
+
+    group.each([&visited](const entis::id_t entity, Transform& transform, Mesh& mesh)
+    {
+        ASSERT_EQ(mesh.name, "e" + std::to_string(transform.x));
+        visited.push_back(entity);
+    });
+
+    ASSERT_EQ(visited.size(), 2);
+}
+
+TEST(GroupTest, KeepsOwnedManagersInLockstep)
+{
+    entis::Registry registry{};
+
+    entis::Group<Transform, Mesh> group = registry.group<Transform, Mesh>();
+
+    std::vector<entis::id_t> entities{};
+
+    for(int i = 0; i < 10; ++i)
+    {
+        const entis::id_t entity = registry.make_entity();
+
+        registry.bind<Transform>(entity, i);
+
+        if(i % 2 == 0)
+            registry.bind<Mesh>(entity, "e" + std::to_string(i));
+
+        entities.push_back(entity);
+    }
+
+    ASSERT_EQ(group.size(), 5);
+
+    registry.unbind<Mesh>(entities[4]);
+    registry.kill_entity(entities[0]);
+    registry.bind<Mesh>(entities[3], std::string{"e3"});
+
+    ASSERT_EQ(group.size(), 4);
+    ASSERT_FALSE(group.contains(entities[4]));
+    ASSERT_TRUE(group.contains(entities[3]));
+
+    size_t count = 0;
+
+    group.each([&count](Transform& transform, Mesh& mesh)
+    {
+        ASSERT_EQ(mesh.name, "e" + std::to_string(transform.x));
+        ++count;
+    });
+
+    ASSERT_EQ(count, 4);
+
+    // the same group is returned when asking for it again.
+    ASSERT_EQ((registry.group<Transform, Mesh>().size()), 4);
+
+    // views over owned components still work.
+    size_t viewed = 0;
+
+    registry.view<Transform, Mesh>().each([&viewed](Transform&, Mesh&) { ++viewed; });
+
+    ASSERT_EQ(viewed, 4);
+}
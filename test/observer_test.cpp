@@ -0,0 +1,212 @@
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+#include <entis/signal.h>
+#include <entis/observer.h>
+#include <entis/registry.h>
+#include <entis/command_buffer.h>
+
+// Utily structs used for testing purposes.
+
+struct Heading
+{
+    Heading(const float angle)
+    : angle{angle}
+    {
+
+    }
+
+    float angle;
+};
+
+struct Score
+{
+    int points;
+};
+
+TEST(SignalTest, CanConnectAndDisconnect)
+{
+    entis::Signal<int&, int> signal{};
+
+    ASSERT_TRUE(signal.empty());
+
+    const entis::Connection add = signal.connect([](int& total, const int value) { total += value; });
+    const entis::Connection twice = signal.connect([](int& total, const int value) { total += value * 2; });
+
+    int total = 0;
+
+    signal.publish(total, 1);
+
+    ASSERT_EQ(total, 3);
+    ASSERT_EQ(signal.size(), 2);
+
+    ASSERT_TRUE(signal.disconnect(twice));
+    ASSERT_FALSE(signal.disconnect(twice));
+
+    signal.publish(total, 1);
+
+    ASSERT_EQ(total, 4);
+
+    ASSERT_TRUE(signal.disconnect(add));
+    ASSERT_TRUE(signal.empty());
+}
+
+TEST(RegistryTest, CanListenToComponentChanges)
+{
+    entis::Registry registry{};
+
+    std::vector<std::pair<char, entis::id_t>> events{};
+
+    registry.on_construct<Heading>().connect([&events](entis::Registry& registry, const entis::id_t entity)
+    {
+        ASSERT_TRUE(registry.has_component<Heading>(entity));
+
+        events.emplace_back('c', entity);
+    });
+
+    registry.on_update<Heading>().connect([&events](entis::Registry&, const entis::id_t entity)
+    {
+        events.emplace_back('u', entity);
+    });
+
+    registry.on_destroy<Heading>().connect([&events](entis::Registry& registry, const entis::id_t entity)
+    {
+        // the component is still accessible.
+        ASSERT_TRUE(registry.has_component<Heading>(entity));
+
+        events.emplace_back('d', entity);
+    });
+
+    const entis::id_t e0 = registry.make_entity();
+    const entis::id_t e1 = registry.make_entity();
+    const entis::id_t e2 = registry.make_entity();
+
+    registry.bind<Heading>(e0, 1.0f);
+    registry.bind<Heading>(e0, 2.0f);
+    registry.patch<Heading>(e0, [](Heading& heading) { heading.angle = 3.0f; });
+    registry.patch<Heading>(e1, [](Heading& heading) { heading.angle = 3.0f; });
+
+    const std::vector<entis::id_t> range{e1, e2};
+
+    registry.bind_range<Heading>(range.begin(), range.end(), 0.0f);
+    registry.erase<Heading>(e1);
+    registry.unbind<Heading>(e1);
+    registry.kill_entity(e2);
+
+    // other component types don't publish anything.
+    registry.bind<Score>(e0, 5);
+
+    const std::vector<std::pair<char, entis::id_t>> expected{
+        {'c', e0}, {'u', e0}, {'u', e0}, {'c', e1}, {'c', e2}, {'d', e1}, {'d', e2}};
+
+    ASSERT_EQ(events, expected);
+}
+
+TEST(ObserverTest, CollectsChangedEntities)
+{
+    entis::Registry registry{};
+
+    std::vector<entis::id_t> entities(6);
+
+    registry.create(entities.size(), entities.begin());
+
+    for(const entis::id_t entity : entities)
+        registry.bind<Heading>(entity, 0.0f);
+
+    entis::Observer<Heading> observer{registry};
+
+    ASSERT_TRUE(observer.empty());
+
+    registry.patch<Heading>(entities[3], [](Heading& heading) { heading.angle = 1.0f; });
+    registry.patch<Heading>(entities[1], [](Heading& heading) { heading.angle = 1.0f; });
+    registry.bind<Heading>(entities[3], 2.0f);
+    registry.kill_entity(entities[1]);
+
+    const entis::id_t spawned = registry.make_entity();
+
+    registry.bind<Heading>(spawned, 4.0f);
+
+    // changes recorded on command buffers are observed once flushed.
+    entis::CommandBuffer buffer{};
+
+    buffer.bind<Heading>(entities[5], 5.0f);
+
+    registry.flush(buffer);
+
+    ASSERT_EQ(observer.entities(), (std::pmr::vector<entis::id_t>{entities[3], spawned, entities[5]}));
+    ASSERT_TRUE(observer.contains(spawned));
+    ASSERT_FALSE(observer.contains(entities[0]));
+
+    observer.clear();
+
+    ASSERT_TRUE(observer.empty());
+
+    registry.patch<Heading>(entities[0], [](Heading& heading) { heading.angle = 1.0f; });
+
+    ASSERT_EQ(observer.size(), 1);
+}
+
+TEST(ObserverTest, DisconnectsWhenDestroyed)
+{
+    entis::Registry registry{};
+
+    {
+        entis::Observer<Score> observer{registry};
+
+        ASSERT_EQ(registry.on_update<Score>().size(), 1);
+    }
+
+    ASSERT_TRUE(registry.on_construct<Score>().empty());
+    ASSERT_TRUE(registry.on_update<Score>().empty());
+    ASSERT_TRUE(registry.on_destroy<Score>().empty());
+
+    registry.bind<Score>(registry.make_entity(), 1);
+}
+
+TEST(ObserverTest, FollowsCompaction)
+{
+    entis::Registry registry{};
+    entis::Observer<Score> observer{registry};
+
+    std::vector<entis::id_t> entities(6);
+
+    registry.create(entities.size(), entities.begin());
+
+    for(const entis::id_t entity : entities)
+        registry.bind<Score>(entity, Score{static_cast<int>(entis::to_index(entity))});
+
+    observer.clear();
+
+    // the last entities are moved to the indices of the killed ones.
+    registry.kill_entity(entities[0]);
+    registry.kill_entity(entities[1]);
+    registry.patch<Score>(entities[5], [](Score& score){ score.points += 10; });
+    registry.patch<Score>(entities[2], [](Score& score){ score.points += 10; });
+
+    std::vector<std::pair<entis::id_t, entis::id_t>> relabels{};
+
+    registry.compact([&relabels](const entis::id_t from, const entis::id_t to)
+    {
+        relabels.emplace_back(from, to);
+    });
+
+    ASSERT_EQ(relabels.size(), 2);
+    ASSERT_EQ(observer.size(), 2);
+
+    // the relabeled entity keeps its place under its new identifier.
+    const auto moved = std::find_if(relabels.begin(), relabels.end(), [&entities](const auto& relabel)
+    {
+        return relabel.first == entities[5];
+    });
+
+    ASSERT_NE(moved, relabels.end());
+    ASSERT_EQ(observer.entities()[0], moved->second);
+    ASSERT_EQ(observer.entities()[1], entities[2]);
+    ASSERT_FALSE(observer.contains(entities[5]));
+
+    ASSERT_EQ(registry.get_component<Score>(moved->second)->get().points, 15);
+    ASSERT_EQ(registry.get_component<Score>(entities[2])->get().points, 12);
+}
@@ -1,14 +1,20 @@
 #include <tuple>
+#include <chrono>
+#include <thread>
 #include <vector>
 #include <string>
+#include <iterator>
+#include <algorithm>
 #include <iostream>
 #include <optional>
+#include <memory_resource>
 
 #include <gtest/gtest.h>
 
 #include <entis/types.h>
 #include <entis/registry.h>
 #include <entis/type_list.h>
+#include <entis/type_index.h>
 #include <entis/sparse_set.h>
 
 // Utily structs used for testing purposes.
@@ -235,10 +241,44 @@ TEST(RegistryTest, CanRecycleEntity)
     registry.kill_entity(e1);
     registry.kill_entity(e3);
 
-    ASSERT_EQ(registry.make_entity(), 3);
-    ASSERT_EQ(registry.make_entity(), 1);
-    ASSERT_EQ(registry.make_entity(), 0);
-    ASSERT_EQ(registry.make_entity(), 2);
+    // recycled entities keep their index but their version is increased.
+    ASSERT_EQ(registry.make_entity(), entis::make_id(3, 1));
+    ASSERT_EQ(registry.make_entity(), entis::make_id(1, 1));
+    ASSERT_EQ(registry.make_entity(), entis::make_id(0, 1));
+    ASSERT_EQ(registry.make_entity(), entis::make_id(2, 1));
+}
+
+TEST(RegistryTest, StaleHandlesAreNotAlive)
+{
+    entis::Registry registry{};
+
+    const entis::id_t e0 = registry.make_entity();
+
+    registry.bind<Vec2>(e0, 1, 1);
+    registry.kill_entity(e0);
+
+    const entis::id_t e1 = registry.make_entity();
+
+    ASSERT_EQ(entis::to_index(e1), entis::to_index(e0));
+    ASSERT_EQ(entis::to_version(e1), entis::to_version(e0) + 1);
+
+    ASSERT_FALSE(registry.is_alive(e0));
+    ASSERT_TRUE(registry.is_alive(e1));
+
+    registry.bind<Vec2>(e1, 2, 2);
+
+    // the stale handle can't reach the components of the new entity.
+    ASSERT_FALSE(registry.has_component<Vec2>(e0));
+    ASSERT_FALSE(registry.get_component<Vec2>(e0).has_value());
+    ASSERT_EQ(registry.bind<Vec2>(e0, 3, 3).value(), entis::error::BindError::DEAD_ENTITY);
+    ASSERT_FALSE(registry.unbind<Vec2>(e0).has_value());
+
+    ASSERT_EQ(registry.get_component<Vec2>(e1).value(), (Vec2{2, 2}));
+
+    registry.kill_entity(e0);
+
+    ASSERT_TRUE(registry.is_alive(e1));
+    ASSERT_FALSE(registry.is_alive(entis::MAX_ID));
 }
 
 TEST(RegistryTest, CanGetMultipleComponents)
@@ -314,3 +354,474 @@ TEST(RegistryTest, CanQueryComponents)
     ASSERT_EQ(std::get<0>(result_without_comp[0]), e1);
     ASSERT_EQ(std::get<1>(result_without_comp[0]), e1_vec2);
 }
+
+TEST(RegistryTest, CanCacheStorage)
+{
+    entis::Registry registry{};
+
+    const entis::id_t e0 = registry.make_entity();
+
+    entis::ComponentManager<Vec2> storage = registry.storage<Vec2>();
+
+    registry.bind<Vec2>(e0, 1, 2);
+
+    ASSERT_EQ(storage, registry.storage<Vec2>());
+    ASSERT_TRUE(storage->has_data(e0));
+    ASSERT_EQ(storage->get_data(e0).value(), (Vec2{1, 2}));
+}
+
+TEST(RegistryTest, CanQueryFromSmallestManager)
+{
+    using WithComp = entis::typing::type_list_t<uint32_t, Vec2>;
+    using WithoutComp = entis::typing::type_list_t<char, Vec3>;
+
+    entis::Registry registry{};
+
+    std::vector<entis::id_t> entities{};
+
+    for(uint32_t i = 0; i < 100; ++i)
+    {
+        const entis::id_t entity = registry.make_entity();
+        registry.bind<uint32_t>(entity, i);
+        entities.push_back(entity);
+    }
+
+    // only a few entities have the rare component (bound in reverse order).
+    registry.bind<Vec2>(entities[90], 9, 0);
+    registry.bind<Vec2>(entities[50], 5, 0);
+    registry.bind<Vec2>(entities[10], 1, 0);
+
+    registry.bind<char>(entities[50], 'a');
+
+    const entis::QueryResult<WithComp> result = registry.query<WithComp, WithoutComp>();
+
+    ASSERT_EQ(result.size(), 2);
+
+    ASSERT_EQ(std::get<0>(result[0]), 90);
+    ASSERT_EQ(std::get<1>(result[0]), (Vec2{9, 0}));
+
+    ASSERT_EQ(std::get<0>(result[1]), 10);
+    ASSERT_EQ(std::get<1>(result[1]), (Vec2{1, 0}));
+}
+
+TEST(RegistryTest, CanModifyComponentInPlace)
+{
+    entis::Registry registry{};
+
+    const entis::id_t e0 = registry.make_entity();
+
+    registry.bind<Vec2>(e0, 1, 2);
+
+    entis::MutableComponent<Vec2> vec2 = registry.get_component<Vec2>(e0);
+
+    vec2.value().get().x = 5;
+
+    ASSERT_EQ(registry.get_component<Vec2>(e0).value(), (Vec2{5, 2}));
+    ASSERT_FALSE(registry.get_component<Vec3>(e0).has_value());
+
+    const entis::Registry& const_registry = registry;
+
+    const entis::Component<Vec2> const_vec2 = const_registry.get_component<Vec2>(e0);
+
+    ASSERT_EQ(const_vec2.value(), (Vec2{5, 2}));
+}
+
+TEST(RegistryTest, CanCreateAndBindInBulk)
+{
+    entis::Registry registry{};
+
+    const entis::id_t killed = registry.make_entity();
+    registry.kill_entity(killed);
+
+    std::vector<entis::id_t> entities{};
+
+    registry.create(100, std::back_inserter(entities));
+
+    ASSERT_EQ(entities.size(), 100);
+    ASSERT_EQ(entis::to_index(entities.front()), entis::to_index(killed));
+
+    for(const entis::id_t entity : entities)
+        ASSERT_TRUE(registry.is_alive(entity));
+
+    registry.reserve<Vec3>(100);
+
+    ASSERT_FALSE(registry.bind_range<Vec2>(entities.begin(), entities.end(), 1, 2).has_value());
+
+    std::vector<Vec3> values{};
+
+    for(int8_t i = 0; i < 100; ++i)
+        values.emplace_back(i, i, i);
+
+    ASSERT_FALSE(registry.insert<Vec3>(entities.begin(), entities.end(), values.begin()).has_value());
+
+    for(size_t i = 0; i < entities.size(); ++i)
+    {
+        ASSERT_EQ(registry.get_component<Vec2>(entities[i]).value(), (Vec2{1, 2}));
+        ASSERT_EQ(registry.get_component<Vec3>(entities[i]).value(), values[i]);
+    }
+
+    registry.kill_entity(entities[5]);
+
+    ASSERT_EQ(registry.bind_range<Vec2>(entities.begin(), entities.end(), 0, 0).value(),
+              entis::error::BindError::DEAD_ENTITY);
+}
+
+TEST(RegistryTest, CanPatchComponents)
+{
+    entis::Registry registry{};
+
+    const entis::id_t e0 = registry.make_entity();
+    const entis::id_t e1 = registry.make_entity();
+
+    std::vector<int> values{1, 2, 3};
+    const int* buffer = values.data();
+
+    registry.bind<std::vector<int>>(e0, std::move(values));
+
+    // the vector was moved into the manager instead of copied.
+    ASSERT_EQ(registry.get_component<std::vector<int>>(e0).value().get().data(), buffer);
+
+    ASSERT_TRUE(registry.patch<std::vector<int>>(e0, [](std::vector<int>& v){ v.push_back(4); }));
+    ASSERT_FALSE(registry.patch<std::vector<int>>(e1, [](std::vector<int>&){}));
+    ASSERT_FALSE(registry.patch<Vec3>(e0, [](Vec3&){}));
+
+    ASSERT_EQ(registry.get_component<std::vector<int>>(e0).value().get().size(), 4);
+}
+
+TEST(RegistryTest, CanDestroyRangesAndErase)
+{
+    entis::Registry registry{};
+
+    std::vector<entis::id_t> entities(8);
+
+    registry.create(entities.size(), entities.begin());
+
+    for(const entis::id_t entity : entities)
+    {
+        registry.bind<Vec2>(entity, 1, 2);
+        registry.bind<Vec3>(entity, 1, 2, 3);
+    }
+
+    ASSERT_TRUE(registry.erase<Vec3>(entities[0]));
+    ASSERT_FALSE(registry.erase<Vec3>(entities[0]));
+    ASSERT_FALSE(registry.erase<char>(entities[0]));
+    ASSERT_FALSE(registry.has_component<Vec3>(entities[0]));
+    ASSERT_TRUE(registry.has_component<Vec2>(entities[0]));
+
+    registry.destroy(entities.begin(), entities.begin() + 4);
+
+    // dead entities are ignored.
+    registry.destroy(entities.begin(), entities.begin() + 2);
+
+    for(size_t i = 0; i < entities.size(); ++i)
+    {
+        ASSERT_EQ(registry.is_alive(entities[i]), i >= 4);
+        ASSERT_EQ(registry.has_component<Vec2>(entities[i]), i >= 4);
+        ASSERT_EQ(registry.has_component<Vec3>(entities[i]), i >= 4);
+    }
+
+    ASSERT_EQ(registry.entities_with_component<Vec2>().size(), 4);
+    ASSERT_EQ(registry.entities_with_component<Vec3>().size(), 4);
+}
+
+TEST(RegistryTest, CanSortComponents)
+{
+    entis::Registry registry{};
+
+    std::vector<entis::id_t> entities(4);
+
+    registry.create(entities.size(), entities.begin());
+
+    for(size_t i = 0; i < entities.size(); ++i)
+    {
+        registry.bind<Vec2>(entities[i], static_cast<int8_t>(i), 0);
+        registry.bind<Vec3>(entities[entities.size() - 1 - i], 0, 0, 0);
+    }
+
+    registry.sort<Vec2>([](const Vec2& a, const Vec2& b) { return a.x > b.x; });
+
+    ASSERT_EQ(registry.storage<Vec2>()->keys(), (std::pmr::vector<entis::id_t>(entities.rbegin(), entities.rend())));
+
+    registry.sort_as<Vec3, Vec2>();
+
+    ASSERT_EQ(registry.storage<Vec3>()->keys(), registry.storage<Vec2>()->keys());
+
+    // views driven by the sorted components follow their order.
+    std::pmr::vector<entis::id_t> visited{};
+
+    registry.view<Vec2>().each([&visited](const entis::id_t entity, Vec2&)
+    {
+        visited.push_back(entity);
+    });
+
+    ASSERT_EQ(visited, registry.storage<Vec2>()->keys());
+}
+
+// Memory resource that counts the bytes it hands out.
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+
+    size_t allocated = 0;
+    size_t outstanding = 0;
+
+private:
+
+    void* do_allocate(const size_t bytes, const size_t alignment) override
+    {
+        allocated += bytes;
+        outstanding += bytes;
+
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* pointer, const size_t bytes, const size_t alignment) override
+    {
+        outstanding -= bytes;
+
+        std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+TEST(RegistryTest, AllocatesFromMemoryResource)
+{
+    CountingResource resource{};
+
+    {
+        entis::Registry registry{&resource};
+
+        ASSERT_EQ(registry.resource(), &resource);
+
+        std::vector<entis::id_t> entities(100);
+
+        registry.create(entities.size(), entities.begin());
+
+        const size_t before = resource.allocated;
+
+        for(const entis::id_t entity : entities)
+            registry.bind<Vec2>(entity, 1, 2);
+
+        ASSERT_GT(resource.allocated, before);
+        ASSERT_EQ(registry.storage<Vec2>()->resource(), &resource);
+    }
+
+    ASSERT_GT(resource.allocated, 0);
+    ASSERT_EQ(resource.outstanding, 0);
+}
+
+TEST(RegistryTest, CanBeReadConcurrentlyWhileFrozen)
+{
+    entis::Registry registry{};
+
+    std::vector<entis::id_t> entities(1000);
+
+    registry.create(entities.size(), entities.begin());
+
+    for(size_t i = 0; i < entities.size(); ++i)
+    {
+        registry.bind<Vec2>(entities[i], static_cast<int8_t>(i % 100), 0);
+
+        if(i % 2 == 0)
+            registry.bind<Vec3>(entities[i], 0, 0, 0);
+    }
+
+    registry.freeze();
+
+    ASSERT_TRUE(registry.frozen());
+
+    std::vector<size_t> found(4, 0);
+    std::vector<std::thread> readers{};
+
+    const entis::Registry& reader = registry;
+
+    for(size_t t = 0; t < found.size(); ++t)
+    {
+        readers.emplace_back([&reader, &entities, &found, t]
+        {
+            for(const entis::id_t entity : entities)
+            {
+                if(reader.has_component<Vec3>(entity) && reader.get_component<Vec2>(entity)->get().y == 0)
+                    ++found[t];
+            }
+        });
+    }
+
+    for(std::thread& thread : readers)
+        thread.join();
+
+    registry.thaw();
+
+    ASSERT_FALSE(registry.frozen());
+    ASSERT_EQ(found, std::vector<size_t>(4, entities.size() / 2));
+}
+
+TEST(RegistryTest, CanGetManyComponents)
+{
+    entis::Registry registry{};
+
+    std::vector<entis::id_t> entities(40);
+
+    registry.create(entities.size(), entities.begin());
+
+    std::vector<const Vec2*> components(entities.size());
+    const entis::Registry& reader = registry;
+
+    // no manager yet.
+    reader.get_many<Vec2>(entities.begin(), entities.end(), components.begin());
+
+    ASSERT_EQ(std::count(components.begin(), components.end(), nullptr), 40);
+
+    for(size_t i = 0; i < entities.size(); i += 2)
+        registry.bind<Vec2>(entities[i], static_cast<int8_t>(i), 0);
+
+    registry.kill_entity(entities[0]);
+
+    reader.get_many<Vec2>(entities.rbegin(), entities.rend(), components.begin());
+
+    for(size_t i = 0; i < entities.size(); ++i)
+    {
+        const size_t position = entities.size() - 1 - i;
+
+        if(position % 2 == 1 || position == 0)
+            ASSERT_EQ(components[i], nullptr);
+        else
+            ASSERT_EQ(components[i]->x, static_cast<int8_t>(position));
+    }
+
+    std::vector<Vec2*> mutable_components(1);
+
+    registry.get_many<Vec2>(entities.begin() + 2, entities.begin() + 3, mutable_components.begin());
+
+    mutable_components[0]->y = 5;
+
+    ASSERT_EQ(registry.get_component<Vec2>(entities[2])->get().y, 5);
+}
+
+TEST(RegistryTest, CanCompactEntities)
+{
+    entis::Registry registry{};
+
+    std::vector<entis::id_t> entities(3 * entis::SPARSE_PAGE_SIZE);
+
+    registry.create(entities.size(), entities.begin());
+
+    for(size_t i = 0; i < entities.size(); ++i)
+    {
+        registry.bind<int>(entities[i], static_cast<int>(i));
+
+        if(i % 2 == 0)
+            registry.bind<Vec2>(entities[i], 1, 2);
+    }
+
+    auto& query = registry.cached_query<int, Vec2>();
+
+    // a wave of entities dies, the survivors are spread over the whole range.
+    std::vector<entis::id_t> survivors{};
+
+    for(size_t i = 0; i < entities.size(); ++i)
+    {
+        if(i % 100 == 0)
+            survivors.push_back(entities[i]);
+        else
+            registry.kill_entity(entities[i]);
+    }
+
+    std::vector<std::pair<entis::id_t, entis::id_t>> relabeled{};
+
+    ASSERT_TRUE(registry.compact([&relabeled](const entis::id_t from, const entis::id_t to)
+    {
+        relabeled.emplace_back(from, to);
+    }));
+
+    // only the survivors past the dense range are moved.
+    ASSERT_EQ(relabeled.size(), static_cast<size_t>(std::count_if(survivors.begin(), survivors.end(),
+        [&survivors](const entis::id_t entity){ return entis::to_index(entity) >= survivors.size(); })));
+
+    for(const auto& [from, to] : relabeled)
+    {
+        std::replace(survivors.begin(), survivors.end(), from, to);
+
+        ASSERT_FALSE(registry.is_alive(from));
+        ASSERT_TRUE(registry.is_alive(to));
+    }
+
+    std::vector<int> values{};
+
+    for(size_t i = 0; i < survivors.size(); ++i)
+    {
+        const entis::id_t entity = survivors[i];
+
+        ASSERT_LT(entis::to_index(entity), survivors.size());
+        ASSERT_EQ(registry.get_component<int>(entity)->get(), static_cast<int>(i * 100));
+        ASSERT_EQ(registry.has_component<Vec2>(entity), (i * 100) % 2 == 0);
+        ASSERT_TRUE(registry.signature(entity).test(entis::TypeIndex::get<int>()));
+        ASSERT_TRUE(query.contains(entity));
+    }
+
+    ASSERT_EQ(query.size(), survivors.size());
+
+    // the pages of the sparse arrays past the survivors were released.
+    for(const entis::PoolStats& stats : registry.pool_stats())
+    {
+        ASSERT_EQ(stats.sparse_pages, 1);
+        ASSERT_EQ(stats.capacity, stats.size);
+    }
+
+    // the lowest dead index is recycled first and old handles stay dead.
+    const entis::id_t spawned = registry.make_entity();
+
+    ASSERT_EQ(entis::to_index(spawned), survivors.size());
+
+    for(const entis::id_t entity : entities)
+    {
+        if(std::find(survivors.begin(), survivors.end(), entity) == survivors.end())
+        {
+            ASSERT_NE(entity, spawned);
+        }
+    }
+}
+
+TEST(RegistryTest, CanCompactOnBudget)
+{
+    entis::Registry registry{};
+
+    std::vector<entis::id_t> entities(1000);
+
+    registry.create(entities.size(), entities.begin());
+
+    for(size_t i = 0; i < entities.size(); ++i)
+    {
+        registry.bind<int>(entities[i], static_cast<int>(i));
+
+        if(i < 500)
+            registry.kill_entity(entities[i]);
+    }
+
+    size_t relabeled = 0;
+
+    const auto count = [&relabeled](const entis::id_t, const entis::id_t) { ++relabeled; };
+
+    // the budget runs out right away, some entities are relabeled anyway.
+    ASSERT_FALSE(registry.compact(count, std::chrono::nanoseconds{0}));
+    ASSERT_GT(relabeled, 0);
+    ASSERT_LT(relabeled, 500);
+
+    // the registry is consistent in between.
+    const entis::id_t spawned = registry.make_entity();
+
+    ASSERT_TRUE(registry.is_alive(spawned));
+
+    registry.kill_entity(spawned);
+
+    ASSERT_TRUE(registry.compact(count));
+    ASSERT_EQ(relabeled, 500);
+    ASSERT_EQ(registry.storage<int>()->size(), 500);
+
+    for(const entis::id_t entity : registry.storage<int>()->keys())
+        ASSERT_LT(entis::to_index(entity), 500);
+}
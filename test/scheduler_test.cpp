@@ -0,0 +1,179 @@
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+#include <entis/registry.h>
+#include <entis/scheduler.h>
+#include <entis/thread_pool.h>
+
+// Utily structs used for testing purposes.
+
+struct Health
+{
+    Health(const int points)
+    : points{points}
+    {
+
+    }
+
+    int points;
+};
+
+struct Armor
+{
+    Armor(const int points)
+    : points{points}
+    {
+
+    }
+
+    int points;
+};
+
+TEST(SchedulerTest, BuildsDependencyGraph)
+{
+    using entis::typing::type_list_t;
+
+    entis::Scheduler scheduler{};
+
+    const size_t write_health = scheduler.add<type_list_t<>, type_list_t<Health>>([](entis::Registry&){});
+    const size_t write_armor = scheduler.add<type_list_t<>, type_list_t<Armor>>([](entis::Registry&){});
+    const size_t read_health = scheduler.add<type_list_t<Health>>([](entis::Registry&){});
+    const size_t read_both = scheduler.add<type_list_t<Health, Armor>>([](entis::Registry&){});
+
+    ASSERT_EQ(scheduler.size(), 4);
+
+    ASSERT_FALSE(scheduler.depends(write_health, write_armor));
+    ASSERT_TRUE(scheduler.depends(write_health, read_health));
+    ASSERT_TRUE(scheduler.depends(write_armor, read_both));
+    ASSERT_TRUE(scheduler.depends(write_health, read_both));
+
+    // readers of the same components don't conflict.
+    ASSERT_FALSE(scheduler.depends(read_health, read_both));
+}
+
+TEST(SchedulerTest, RunsSystemsInDependencyOrder)
+{
+    using entis::typing::type_list_t;
+
+    entis::Registry registry{};
+    entis::ThreadPool pool{4};
+    entis::Scheduler scheduler{};
+
+    for(int i = 0; i < 100; ++i)
+    {
+        const entis::id_t entity = registry.make_entity();
+
+        registry.bind<Health>(entity, 10);
+        registry.bind<Armor>(entity, 1);
+    }
+
+    std::mutex mutex{};
+    std::vector<std::string> order{};
+
+    const auto record = [&mutex, &order](const std::string& name)
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        order.push_back(name);
+    };
+
+    scheduler.add<type_list_t<>, type_list_t<Health>>([&record](entis::Registry& registry)
+    {
+        registry.view<Health>().each([](Health& health){ health.points *= 2; });
+        record("heal");
+    });
+
+    scheduler.add<type_list_t<>, type_list_t<Armor>>([&record](entis::Registry& registry)
+    {
+        registry.view<Armor>().each([](Armor& armor){ armor.points += 1; });
+        record("repair");
+    });
+
+    scheduler.add<type_list_t<Armor>, type_list_t<Health>>([&record](entis::Registry& registry)
+    {
+        registry.view<Health, Armor>().each([](Health& health, const Armor& armor)
+        {
+            health.points += armor.points;
+        });
+
+        record("absorb");
+    });
+
+    for(int frame = 0; frame < 10; ++frame)
+    {
+        order.clear();
+
+        scheduler.run(registry, pool);
+
+        ASSERT_EQ(order.size(), 3);
+        ASSERT_EQ(order.back(), "absorb");
+    }
+
+    registry.view<Health, Armor>().each([](const Health& health, const Armor& armor)
+    {
+        ASSERT_EQ(armor.points, 11);
+        ASSERT_GT(health.points, 0);
+    });
+}
+
+TEST(SchedulerTest, FreezesRegistryWhileRunning)
+{
+    using entis::typing::type_list_t;
+
+    entis::Registry registry{};
+    entis::ThreadPool pool{2};
+    entis::Scheduler scheduler{};
+
+    std::atomic<int> frozen{0};
+
+    scheduler.add<type_list_t<Health>>([&frozen](entis::Registry& registry)
+    {
+        if(registry.frozen())
+            ++frozen;
+    });
+
+    scheduler.add<type_list_t<Armor>>([&frozen](entis::Registry& registry)
+    {
+        if(registry.frozen())
+            ++frozen;
+    });
+
+    scheduler.run(registry, pool);
+
+    ASSERT_EQ(frozen.load(), 2);
+    ASSERT_FALSE(registry.frozen());
+}
+
+TEST(SchedulerTest, SystemsCanPatchWhileFrozen)
+{
+    using entis::typing::type_list_t;
+
+    entis::Registry registry{};
+    entis::ThreadPool pool{2};
+    entis::Scheduler scheduler{};
+
+    const entis::id_t entity = registry.make_entity();
+
+    registry.bind<Health>(entity, 10);
+    registry.bind<Armor>(entity, 5);
+
+    scheduler.add<type_list_t<>, type_list_t<Health>>([entity](entis::Registry& registry)
+    {
+        registry.patch<Health>(entity, [](Health& health){ health.points += 1; });
+    });
+
+    scheduler.add<type_list_t<>, type_list_t<Armor>>([entity](entis::Registry& registry)
+    {
+        registry.get_component<Armor>(entity)->get().points *= 2;
+    });
+
+    scheduler.run(registry, pool);
+
+    ASSERT_EQ(registry.get_component<Health>(entity)->get().points, 11);
+    ASSERT_EQ(registry.get_component<Armor>(entity)->get().points, 10);
+    ASSERT_FALSE(registry.frozen());
+}
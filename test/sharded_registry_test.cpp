@@ -0,0 +1,110 @@
+#include <atomic>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <entis/registry.h>
+#include <entis/thread_pool.h>
+#include <entis/sharded_registry.h>
+
+// Utily structs used for testing purposes.
+
+struct Cell
+{
+    int value;
+};
+
+struct Asleep
+{
+};
+
+TEST(ShardedRegistryTest, KeepsEntitiesOnTheirShard)
+{
+    entis::ShardedRegistry registry{2};
+
+    ASSERT_EQ(registry.size(), 2);
+
+    const entis::ShardedRegistry::Entity a = registry.make_entity(0);
+    const entis::ShardedRegistry::Entity b = registry.make_entity(1);
+
+    // every shard has its own identifiers.
+    ASSERT_EQ(a.id, b.id);
+
+    ASSERT_FALSE(registry.bind<Cell>(a, 1).has_value());
+    ASSERT_FALSE(registry.bind<Cell>(b, 2).has_value());
+
+    ASSERT_EQ(registry.get_component<Cell>(a)->get().value, 1);
+    ASSERT_EQ(registry.get_component<Cell>(b)->get().value, 2);
+    ASSERT_EQ(registry.shard(0).storage<Cell>()->size(), 1);
+
+    registry.kill_entity(a);
+
+    ASSERT_FALSE(registry.is_alive(a));
+    ASSERT_TRUE(registry.is_alive(b));
+    ASSERT_TRUE(registry.has_component<Cell>(b));
+    ASSERT_TRUE(registry.erase<Cell>(b));
+    ASSERT_FALSE(registry.has_component<Cell>(b));
+}
+
+TEST(ShardedRegistryTest, ChangesShardsConcurrently)
+{
+    entis::ShardedRegistry registry{8};
+    entis::ThreadPool pool{4};
+
+    // every shard changes its structure on its own task.
+    registry.parallel(pool, [](entis::Registry& shard, const size_t index)
+    {
+        for(int i = 0; i < 100; ++i)
+        {
+            const entis::id_t entity = shard.make_entity();
+
+            shard.bind<Cell>(entity, static_cast<int>(index));
+
+            if(i % 2 == 0)
+                shard.bind<Asleep>(entity);
+        }
+    });
+
+    std::atomic<int> visited{0};
+
+    registry.each<Cell>(pool, [&visited](const entis::ShardedRegistry::Entity entity, Cell& cell)
+    {
+        ASSERT_EQ(static_cast<size_t>(cell.value), entity.shard);
+
+        ++cell.value;
+        ++visited;
+    }, entis::exclude<Asleep>);
+
+    ASSERT_EQ(visited.load(), 8 * 50);
+
+    for(size_t i = 0; i < registry.size(); ++i)
+        ASSERT_EQ(registry.shard(i).storage<Cell>()->size(), 100);
+}
+
+TEST(ShardedRegistryTest, EachLeavesTagsOut)
+{
+    entis::ShardedRegistry registry{2};
+    entis::ThreadPool pool{2};
+
+    for(size_t i = 0; i < registry.size(); ++i)
+    {
+        const entis::ShardedRegistry::Entity awake = registry.make_entity(i);
+        const entis::ShardedRegistry::Entity asleep = registry.make_entity(i);
+
+        registry.bind<Cell>(awake, 1);
+        registry.bind<Cell>(asleep, 2);
+        registry.bind<Asleep>(asleep);
+    }
+
+    std::atomic<int> visited{0};
+
+    // the tag filters the entities but isn't passed to the function.
+    registry.each<Cell, Asleep>(pool, [&visited](const entis::ShardedRegistry::Entity, Cell& cell)
+    {
+        ASSERT_EQ(cell.value, 2);
+
+        ++visited;
+    });
+
+    ASSERT_EQ(visited.load(), 2);
+}
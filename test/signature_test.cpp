@@ -0,0 +1,142 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <entis/signature.h>
+#include <entis/registry.h>
+
+// Utily structs used for testing purposes.
+
+struct Mass
+{
+    Mass(const float value)
+    : value{value}
+    {
+
+    }
+
+    float value;
+};
+
+struct Charge
+{
+    Charge(const int value)
+    : value{value}
+    {
+
+    }
+
+    int value;
+};
+
+struct Frozen
+{
+};
+
+TEST(SignatureTest, CanSetAndTestBits)
+{
+    entis::Signature signature{};
+
+    ASSERT_TRUE(signature.empty());
+
+    signature.set(3);
+    signature.set(70);
+
+    ASSERT_TRUE(signature.test(3));
+    ASSERT_TRUE(signature.test(70));
+    ASSERT_FALSE(signature.test(4));
+    ASSERT_FALSE(signature.test(entis::MAX_COMPONENTS));
+
+    entis::Signature with{};
+    entis::Signature without{};
+
+    with.set(3);
+    without.set(4);
+
+    ASSERT_TRUE(signature.contains(with));
+    ASSERT_FALSE(signature.intersects(without));
+    ASSERT_TRUE(signature.matches(with, without));
+
+    signature.set(4);
+
+    ASSERT_FALSE(signature.matches(with, without));
+
+    signature.reset(4);
+    signature.reset(70);
+
+    ASSERT_EQ(signature, with);
+
+    signature.clear();
+
+    ASSERT_TRUE(signature.empty());
+}
+
+TEST(SignatureTest, RegistryTracksSignatures)
+{
+    entis::Registry registry{};
+
+    const entis::id_t e0 = registry.make_entity();
+    const entis::id_t e1 = registry.make_entity();
+
+    registry.bind<Mass>(e0, 1.0f);
+    registry.bind<Charge>(e0, 2);
+    registry.bind<Mass>(e1, 3.0f);
+
+    ASSERT_EQ(registry.signature(e0), (entis::Signature::of<Mass, Charge>()));
+    ASSERT_EQ(registry.signature(e1), (entis::Signature::of<Mass>()));
+
+    registry.unbind<Charge>(e0);
+
+    ASSERT_EQ(registry.signature(e0), (entis::Signature::of<Mass>()));
+
+    // unbinding through a stale handle doesn't touch the new entity.
+    registry.kill_entity(e1);
+
+    const entis::id_t e2 = registry.make_entity();
+
+    registry.bind<Charge>(e2, 4);
+    registry.unbind<Charge>(e1);
+
+    ASSERT_FALSE(registry.signature(e2).empty());
+    ASSERT_EQ(registry.signature(e2), (entis::Signature::of<Charge>()));
+}
+
+TEST(SignatureTest, ViewsMatchSignatures)
+{
+    entis::Registry registry{};
+
+    std::vector<entis::id_t> entities(10);
+
+    registry.create(entities.size(), entities.begin());
+
+    for(size_t i = 0; i < entities.size(); ++i)
+    {
+        registry.bind<Mass>(entities[i], static_cast<float>(i));
+
+        if(i % 2 == 0)
+            registry.bind<Charge>(entities[i], static_cast<int>(i));
+
+        if(i % 4 == 0)
+            registry.bind<Frozen>(entities[i]);
+    }
+
+    std::vector<entis::id_t> visited{};
+
+    registry.view<Mass, Charge>(entis::exclude<Frozen>).each([&visited](const entis::id_t entity, Mass&, Charge&)
+    {
+        visited.push_back(entity);
+    });
+
+    ASSERT_EQ(visited, (std::vector<entis::id_t>{entities[2], entities[6]}));
+
+    registry.unbind<Frozen>(entities[4]);
+    registry.kill_entity(entities[6]);
+
+    visited.clear();
+
+    for(auto [entity, mass, charge] : registry.view<Mass, Charge>(entis::exclude<Frozen>))
+        visited.push_back(entity);
+
+    ASSERT_EQ(visited.size(), 2);
+    ASSERT_EQ(registry.query<entis::typing::type_list_t<Charge>>().size(), 4);
+}
@@ -0,0 +1,270 @@
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+
+#include <gtest/gtest.h>
+
+#include <entis/soa.h>
+#include <entis/storage.h>
+#include <entis/registry.h>
+#include <entis/snapshot.h>
+
+// Utily structs used for testing purposes.
+
+struct Orbit
+{
+    float radius;
+    float period;
+};
+
+struct Trail
+{
+    int length;
+};
+
+struct Spark
+{
+    float heat;
+    int ttl;
+};
+
+struct Label
+{
+    std::string text;
+};
+
+struct Hidden
+{
+};
+
+template <>
+struct entis::storage_traits<Trail>
+{
+    static constexpr bool in_place_delete = true;
+    static constexpr size_t page_size = 8;
+};
+
+template <>
+struct entis::soa_traits<Spark>
+{
+    static constexpr auto fields = std::make_tuple(&Spark::heat, &Spark::ttl);
+};
+
+static void write_label(entis::OutputArchive& archive, const Label& label)
+{
+    archive.write(static_cast<uint32_t>(label.text.size()));
+    archive.write(label.text.data(), label.text.size());
+}
+
+static Label read_label(entis::InputArchive& archive)
+{
+    uint32_t size = 0;
+
+    archive.read(size);
+
+    const char* text = archive.block<char>(size);
+
+    return Label{text ? std::string{text, size} : std::string{}};
+}
+
+TEST(SnapshotTest, CanSaveAndLoadRegistry)
+{
+    entis::Registry source{};
+
+    std::vector<entis::id_t> entities(10);
+
+    source.create(entities.size(), entities.begin());
+
+    for(size_t i = 0; i < entities.size(); ++i)
+    {
+        const float value = static_cast<float>(i);
+
+        source.bind<Orbit>(entities[i], value, value * 2.0f);
+
+        if(i % 2 == 0)
+            source.bind<Trail>(entities[i], static_cast<int>(i));
+
+        if(i % 3 == 0)
+            source.bind<Spark>(entities[i], value, static_cast<int>(i));
+
+        if(i % 4 == 0)
+            source.bind<Hidden>(entities[i]);
+
+        source.bind<Label>(entities[i], std::string(i + 1, 'x'));
+    }
+
+    // the free list and the holes of paged components are kept.
+    source.unbind<Trail>(entities[2]);
+    source.kill_entity(entities[5]);
+    source.kill_entity(entities[7]);
+
+    std::vector<std::byte> buffer{};
+    entis::OutputArchive output{buffer};
+
+    entis::Snapshot{source}
+        .entities(output)
+        .component<Orbit>(output)
+        .component<Trail>(output)
+        .component<Spark>(output)
+        .component<Hidden>(output)
+        .component<Label>(output, write_label);
+
+    entis::Registry target{};
+    entis::InputArchive input{buffer.data(), buffer.size()};
+    entis::SnapshotLoader loader{target};
+
+    ASSERT_FALSE(loader.entities(input).has_value());
+    ASSERT_FALSE(loader.component<Orbit>(input).has_value());
+    ASSERT_FALSE(loader.component<Trail>(input).has_value());
+    ASSERT_FALSE(loader.component<Spark>(input).has_value());
+    ASSERT_FALSE(loader.component<Hidden>(input).has_value());
+    ASSERT_FALSE(loader.component<Label>(input, read_label).has_value());
+    ASSERT_EQ(input.position(), buffer.size());
+
+    for(size_t i = 0; i < entities.size(); ++i)
+    {
+        const entis::id_t entity = entities[i];
+
+        ASSERT_EQ(target.is_alive(entity), source.is_alive(entity));
+
+        if(!source.is_alive(entity))
+            continue;
+
+        ASSERT_EQ(target.get_component<Orbit>(entity)->get().period, static_cast<float>(i) * 2.0f);
+        ASSERT_EQ(target.has_component<Trail>(entity), source.has_component<Trail>(entity));
+        ASSERT_EQ(target.has_component<Spark>(entity), source.has_component<Spark>(entity));
+        ASSERT_EQ(target.has_component<Hidden>(entity), source.has_component<Hidden>(entity));
+        ASSERT_EQ(target.get_component<Label>(entity)->get().text, std::string(i + 1, 'x'));
+        ASSERT_EQ(target.signature(entity), source.signature(entity));
+
+        if(source.has_component<Spark>(entity))
+        {
+            ASSERT_EQ(target.storage<Spark>()->get(entity).ttl, static_cast<int>(i));
+        }
+    }
+
+    // recycling continues where it was.
+    ASSERT_EQ(target.make_entity(), source.make_entity());
+    ASSERT_EQ((target.view<Orbit, Hidden>().size_hint()), (source.view<Orbit, Hidden>().size_hint()));
+}
+
+TEST(SnapshotTest, RejectsInvalidArchives)
+{
+    entis::Registry source{};
+
+    const entis::id_t entity = source.make_entity();
+
+    source.bind<Orbit>(entity, 1.0f, 2.0f);
+
+    std::vector<std::byte> buffer{};
+    entis::OutputArchive output{buffer};
+
+    entis::Snapshot{source}.entities(output).component<Orbit>(output);
+
+    {
+        // truncated component block.
+        entis::Registry target{};
+        entis::InputArchive input{buffer.data(), buffer.size() - 1};
+        entis::SnapshotLoader loader{target};
+
+        ASSERT_FALSE(loader.entities(input).has_value());
+        ASSERT_EQ(loader.component<Orbit>(input), entis::error::LoadError::TRUNCATED);
+    }
+
+    {
+        // not a snapshot.
+        std::vector<std::byte> garbage(buffer.size(), std::byte{0x7f});
+
+        entis::Registry target{};
+        entis::InputArchive input{garbage.data(), garbage.size()};
+
+        ASSERT_EQ(entis::SnapshotLoader{target}.entities(input), entis::error::LoadError::BAD_FORMAT);
+    }
+
+    {
+        // only empty registries can be loaded.
+        entis::InputArchive input{buffer.data(), buffer.size()};
+
+        ASSERT_EQ(entis::SnapshotLoader{source}.entities(input), entis::error::LoadError::NOT_EMPTY);
+    }
+}
+
+TEST(SnapshotTest, RejectsCorruptedEntityTables)
+{
+    entis::Registry source{};
+
+    std::vector<entis::id_t> entities(4);
+
+    source.create(entities.size(), entities.begin());
+
+    // the list of dead entities is 2 -> 1 -> end.
+    source.kill_entity(entities[1]);
+    source.kill_entity(entities[2]);
+
+    std::vector<std::byte> buffer{};
+    entis::OutputArchive output{buffer};
+
+    entis::Snapshot{source}.entities(output);
+
+    // the table is the last block of the archive.
+    const size_t table = buffer.size() - entities.size() * sizeof(entis::id_t);
+
+    const auto load = [&buffer, table](const size_t slot, const entis::id_t value)
+    {
+        std::vector<std::byte> corrupted = buffer;
+
+        std::memcpy(corrupted.data() + table + slot * sizeof(entis::id_t), &value, sizeof(entis::id_t));
+
+        entis::Registry target{};
+        entis::InputArchive input{corrupted.data(), corrupted.size()};
+
+        return entis::SnapshotLoader{target}.entities(input);
+    };
+
+    // a loop on the list of dead entities.
+    ASSERT_EQ(load(1, entis::make_id(2, 1)), entis::error::LoadError::BAD_FORMAT);
+
+    // a link past the table.
+    ASSERT_EQ(load(2, entis::make_id(100, 1)), entis::error::LoadError::BAD_FORMAT);
+
+    // a link to an alive entity.
+    ASSERT_EQ(load(1, entis::make_id(3, 1)), entis::error::LoadError::BAD_FORMAT);
+
+    // an alive slot that holds another index (a dead slot out of the list).
+    ASSERT_EQ(load(0, entis::make_id(3, 0)), entis::error::LoadError::BAD_FORMAT);
+
+    // the original table loads fine.
+    ASSERT_FALSE(load(0, entities[0]).has_value());
+}
+
+TEST(SnapshotTest, RejectsRepeatedKeys)
+{
+    entis::Registry source{};
+
+    const entis::id_t entity = source.make_entity();
+
+    source.make_entity();
+
+    std::vector<std::byte> buffer{};
+    entis::OutputArchive output{buffer};
+
+    entis::Snapshot{source}.entities(output);
+
+    // a block of components whose key is repeated.
+    const entis::id_t keys[] = {entity, entity};
+    const Orbit values[] = {{1.0f, 2.0f}, {3.0f, 4.0f}};
+
+    output.write(uint64_t{2});
+    output.write(keys, 2);
+    output.write(values, 2);
+
+    entis::Registry target{};
+    entis::InputArchive input{buffer.data(), buffer.size()};
+    entis::SnapshotLoader loader{target};
+
+    ASSERT_FALSE(loader.entities(input).has_value());
+    ASSERT_EQ(loader.component<Orbit>(input), entis::error::LoadError::BAD_FORMAT);
+}
@@ -0,0 +1,178 @@
+#include <tuple>
+#include <vector>
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+#include <entis/soa.h>
+#include <entis/registry.h>
+
+// Utily structs used for testing purposes.
+
+struct Particle
+{
+    float x;
+    float y;
+    int life;
+
+    bool operator==(const Particle& other) const
+    {
+        return x == other.x && y == other.y && life == other.life;
+    }
+};
+
+template <>
+struct entis::soa_traits<Particle>
+{
+    static constexpr auto fields = std::make_tuple(&Particle::x, &Particle::y, &Particle::life);
+};
+
+TEST(SoATest, DetectsSoAComponents)
+{
+    ASSERT_TRUE(entis::is_soa_v<Particle>);
+    ASSERT_FALSE(entis::is_soa_v<int>);
+
+    ASSERT_TRUE((std::is_same_v<entis::ComponentManager<Particle>, entis::SoASet<Particle>*>));
+    ASSERT_TRUE((std::is_same_v<entis::ComponentManager<int>, entis::SparseSet<int>*>));
+}
+
+TEST(SoATest, StoresEveryFieldOnItsOwnArray)
+{
+    entis::SoASet<Particle> set{};
+
+    set.bind(0, 1.0f, 2.0f, 3);
+    set.bind(4, Particle{4.0f, 5.0f, 6});
+    set.bind(9, 7.0f, 8.0f, 9);
+
+    ASSERT_EQ(set.size(), 3);
+    ASSERT_EQ(set.get(4), (Particle{4.0f, 5.0f, 6}));
+    ASSERT_FALSE(set.get_data(5).has_value());
+
+    entis::FieldSpan<float> xs = set.field<0>();
+    entis::FieldSpan<int> lives = set.field<2>();
+
+    ASSERT_EQ(xs.size(), 3);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(xs.data()) % entis::SOA_ALIGNMENT, 0);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(lives.data()) % entis::SOA_ALIGNMENT, 0);
+
+    // the i-th value of every field belongs to the i-th key.
+    for(size_t i = 0; i < xs.size(); ++i)
+        ASSERT_EQ(xs[i], set.get(set.keys()[i]).x);
+
+    set.field<1>(9) = 10.0f;
+
+    ASSERT_EQ(set.get(9).y, 10.0f);
+}
+
+TEST(SoATest, CanUpdateAndUnbind)
+{
+    entis::SoASet<Particle> set{};
+
+    set.bind(0, 1.0f, 1.0f, 1);
+    set.bind(1, 2.0f, 2.0f, 2);
+    set.bind(2, 3.0f, 3.0f, 3);
+
+    set.bind(1, 5.0f, 5.0f, 5);
+
+    ASSERT_EQ(set.size(), 3);
+    ASSERT_EQ(set.get(1), (Particle{5.0f, 5.0f, 5}));
+
+    ASSERT_TRUE(set.patch(2, [](Particle& p){ p.life += 10; }));
+    ASSERT_EQ(set.field<2>(2), 13);
+
+    ASSERT_EQ(set.unbind(0).value(), (Particle{1.0f, 1.0f, 1}));
+    ASSERT_FALSE(set.unbind(0).has_value());
+
+    ASSERT_EQ(set.size(), 2);
+    ASSERT_EQ(set.field<0>().size(), 2);
+    ASSERT_EQ(set.get(2), (Particle{3.0f, 3.0f, 13}));
+    ASSERT_EQ(set.get(1), (Particle{5.0f, 5.0f, 5}));
+}
+
+TEST(SoATest, RegistryStoresSoAComponents)
+{
+    entis::Registry registry{};
+
+    std::vector<entis::id_t> entities(8);
+
+    registry.create(entities.size(), entities.begin());
+
+    for(const entis::id_t entity : entities)
+        registry.bind<Particle>(entity, 0.0f, 0.0f, static_cast<int>(entis::to_index(entity)));
+
+    registry.kill_entity(entities[3]);
+
+    ASSERT_FALSE(registry.has_component<Particle>(entities[3]));
+    ASSERT_TRUE(registry.has_component<Particle>(entities[4]));
+
+    entis::SoASet<Particle>* particles = registry.storage<Particle>();
+
+    entis::FieldSpan<float> xs = particles->field<0>();
+    entis::FieldSpan<const int> lives = static_cast<const entis::SoASet<Particle>*>(particles)->field<2>();
+
+    for(size_t i = 0; i < xs.size(); ++i)
+        xs[i] += static_cast<float>(lives[i]);
+
+    ASSERT_EQ(particles->size(), 7);
+    ASSERT_EQ(particles->get(entities[5]).x, 5.0f);
+    ASSERT_EQ(registry.unbind<Particle>(entities[5]).value().life, 5);
+}
+
+struct Emitter
+{
+    int rate;
+};
+
+struct Expired
+{
+};
+
+TEST(SoATest, ViewsJoinSoAComponents)
+{
+    entis::Registry registry{};
+
+    std::vector<entis::id_t> entities(6);
+
+    registry.create(entities.size(), entities.begin());
+
+    for(size_t i = 0; i < entities.size(); ++i)
+        registry.bind<Particle>(entities[i], 0.0f, 0.0f, 100);
+
+    registry.bind<Emitter>(entities[1], 10);
+    registry.bind<Emitter>(entities[2], 20);
+    registry.bind<Emitter>(entities[4], 40);
+    registry.bind<Expired>(entities[2]);
+
+    auto view = registry.view<Particle, Emitter>(entis::exclude<Expired>);
+    auto life = view.field<Particle, 2>();
+
+    ASSERT_EQ(life.size(), entities.size());
+
+    // the SoA component is a filter, its fields are reached by position.
+    view.each([&view, &life](const entis::id_t entity, Emitter& emitter)
+    {
+        life[view.index<Particle>(entity)] -= emitter.rate;
+    });
+
+    const entis::SoASet<Particle>* particles = registry.storage<Particle>();
+
+    ASSERT_EQ(particles->get(entities[0]).life, 100);
+    ASSERT_EQ(particles->get(entities[1]).life, 90);
+    ASSERT_EQ(particles->get(entities[2]).life, 100);
+    ASSERT_EQ(particles->get(entities[4]).life, 60);
+
+    // a query over a SoA component alone yields the entities only.
+    size_t visited = 0;
+
+    registry.view<Particle>(entis::exclude<Emitter>).each([&visited](const entis::id_t)
+    {
+        ++visited;
+    });
+
+    ASSERT_EQ(visited, 3);
+
+    // views over managers that don't exist yet are empty.
+    entis::Registry empty{};
+
+    ASSERT_EQ((empty.view<Particle, Emitter>().field<Particle, 0>().size()), 0);
+}
@@ -1,7 +1,11 @@
+#include <array>
 #include <string>
+#include <cstddef>
+#include <vector>
 #include <limits>
 #include <optional>
 #include <iostream>
+#include <memory_resource>
 
 #include <gtest/gtest.h>
 
@@ -80,4 +84,464 @@ TEST(SparseSetTest, CanUnbindData)
 
     ASSERT_FALSE(set.get_data(e0).has_value());
     ASSERT_FALSE(set.get_data(e1).has_value());
-}
\ No newline at end of file
+}
+TEST(SparseSetTest, CanModifyDataInPlace)
+{
+    entis::SparseSet<std::string> set{};
+
+    set.bind(0, std::string{"first"});
+    set.bind(1, std::string{"second"});
+
+    set.get_data(0).value().get() += "!";
+
+    ASSERT_EQ(set.get_data(0).value().get(), std::string{"first!"});
+    ASSERT_FALSE(set.get_data(2).has_value());
+}
+
+TEST(SparseSetTest, CanIteratePackedData)
+{
+    entis::SparseSet<int> set{};
+
+    set.bind(5, 5);
+    set.bind(2, 2);
+    set.bind(9, 9);
+
+    ASSERT_EQ(set.size(), 3);
+
+    for(int& value : set)
+        value *= 10;
+
+    for(size_t i = 0; i < set.size(); ++i)
+        ASSERT_EQ(set.data()[i], static_cast<int>(set.keys()[i]) * 10);
+}
+
+TEST(SparseSetTest, CanBindScatteredKeys)
+{
+    entis::SparseSet<int> set{};
+
+    const entis::id_t low = 3;
+    const entis::id_t high = 4000000;
+    const entis::id_t page_end = entis::SPARSE_PAGE_SIZE - 1;
+
+    set.bind(high, 1);
+    set.bind(low, 2);
+    set.bind(page_end, 3);
+
+    ASSERT_TRUE(set.has_data(high));
+    ASSERT_TRUE(set.has_data(low));
+    ASSERT_TRUE(set.has_data(page_end));
+
+    // keys on pages that were never allocated.
+    ASSERT_FALSE(set.has_data(high - entis::SPARSE_PAGE_SIZE));
+    ASSERT_FALSE(set.has_data(high + 1));
+
+    ASSERT_EQ(set.unbind(high).value(), 1);
+    ASSERT_FALSE(set.has_data(high));
+
+    ASSERT_EQ(set.get_data(low).value().get(), 2);
+    ASSERT_EQ(set.get_data(page_end).value().get(), 3);
+}
+
+TEST(SparseSetTest, CanBindRanges)
+{
+    entis::SparseSet<int> set{};
+
+    const std::vector<entis::id_t> keys{0, 7, 3, 10000};
+    const std::vector<int> values{1, 2, 3, 4};
+
+    ASSERT_FALSE(set.bind_range(keys.begin(), keys.end(), 5).has_value());
+
+    ASSERT_EQ(set.size(), 4);
+    ASSERT_GE(set.capacity(), 4);
+
+    for(const entis::id_t key : keys)
+        ASSERT_EQ(set.get_data(key).value().get(), 5);
+
+    ASSERT_FALSE(set.insert(keys.begin(), keys.end(), values.begin()).has_value());
+
+    ASSERT_EQ(set.size(), 4);
+
+    for(size_t i = 0; i < keys.size(); ++i)
+        ASSERT_EQ(set.get_data(keys[i]).value().get(), values[i]);
+
+    const std::vector<entis::id_t> invalid{1, entis::MAX_ID};
+
+    ASSERT_TRUE(set.bind_range(invalid.begin(), invalid.end(), 0).has_value());
+    ASSERT_TRUE(set.has_data(1));
+}
+
+TEST(SparseSetTest, TellsVersionsApart)
+{
+    entis::SparseSet<int> set{};
+
+    const entis::id_t old_key = entis::make_id(7, 0);
+    const entis::id_t new_key = entis::make_id(7, 1);
+
+    set.bind(old_key, 1);
+
+    ASSERT_TRUE(set.has_data(old_key));
+    ASSERT_FALSE(set.has_data(new_key));
+
+    // a newer version of the index replaces the old association.
+    set.bind(new_key, 2);
+
+    ASSERT_EQ(set.size(), 1);
+    ASSERT_FALSE(set.has_data(old_key));
+    ASSERT_EQ(set.get_data(new_key).value().get(), 2);
+    ASSERT_FALSE(set.unbind(old_key).has_value());
+}
+
+struct Counted
+{
+    static inline int copies = 0;
+    static inline int moves = 0;
+
+    std::vector<int> values;
+
+    Counted(std::vector<int> v) : values{std::move(v)} {}
+    Counted(const Counted& other) : values{other.values} { ++copies; }
+    Counted(Counted&& other) noexcept : values{std::move(other.values)} { ++moves; }
+    Counted& operator=(const Counted& other) { values = other.values; ++copies; return *this; }
+    Counted& operator=(Counted&& other) noexcept { values = std::move(other.values); ++moves; return *this; }
+};
+
+struct Aggregate
+{
+    int a;
+    float b;
+};
+
+TEST(SparseSetTest, BindsWithoutTemporaries)
+{
+    entis::SparseSet<Counted> set{};
+
+    set.reserve(2);
+
+    Counted::copies = 0;
+    Counted::moves = 0;
+
+    // constructed in place.
+    set.bind(0, std::vector<int>{1, 2, 3});
+
+    ASSERT_EQ(Counted::copies, 0);
+    ASSERT_EQ(Counted::moves, 0);
+
+    // rvalues are moved, not copied.
+    set.bind(1, Counted{std::vector<int>{4}});
+    set.bind(0, Counted{std::vector<int>{5, 6}});
+
+    ASSERT_EQ(Counted::copies, 0);
+    ASSERT_EQ(Counted::moves, 2);
+    ASSERT_EQ(set.get(0).values, (std::vector<int>{5, 6}));
+
+    entis::SparseSet<Aggregate> aggregates{};
+
+    aggregates.bind(3, 1, 2.0f);
+    aggregates.bind(3, 4, 8.0f);
+
+    ASSERT_EQ(aggregates.get(3).a, 4);
+}
+
+struct Scrambled
+{
+    Scrambled(const int& a, const int& b) noexcept
+    : a{a},
+      b{b}
+    {
+
+    }
+
+    // a dead value can't be mistaken for a live one.
+    ~Scrambled()
+    {
+        a = -1;
+        b = -1;
+    }
+
+    Scrambled(const Scrambled&) = default;
+    Scrambled& operator=(const Scrambled&) = default;
+
+    int a;
+    int b;
+};
+
+struct Tracked
+{
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+    Tracked(const int value) noexcept
+    : value{value},
+      resource{std::pmr::get_default_resource()}
+    {
+
+    }
+
+    Tracked(const int value, const allocator_type& allocator) noexcept
+    : value{value},
+      resource{allocator.resource()}
+    {
+
+    }
+
+    Tracked(const Tracked& other, const allocator_type& allocator) noexcept
+    : value{other.value},
+      resource{allocator.resource()}
+    {
+
+    }
+
+    Tracked(const Tracked&) = default;
+    Tracked& operator=(const Tracked&) = default;
+
+    int value;
+    std::pmr::memory_resource* resource;
+};
+
+TEST(SparseSetTest, ReplacesValuesSafely)
+{
+    entis::SparseSet<Scrambled> set{};
+
+    set.bind(0, 1, 2);
+
+    // the arguments refer to the old value.
+    set.bind(0, set.get(0).b, set.get(0).a);
+
+    ASSERT_EQ(set.get(0).a, 2);
+    ASSERT_EQ(set.get(0).b, 1);
+
+    std::pmr::unsynchronized_pool_resource pool{};
+    entis::SparseSet<Tracked> tracked{&pool};
+
+    tracked.bind(0, 1);
+    tracked.bind(0, 2);
+
+    // the new value is made with the resource of the set too.
+    ASSERT_EQ(tracked.get(0).value, 2);
+    ASSERT_EQ(tracked.get(0).resource, &pool);
+}
+
+TEST(SparseSetTest, CanPatchData)
+{
+    entis::SparseSet<Counted> set{};
+
+    set.bind(2, std::vector<int>{1});
+
+    Counted::copies = 0;
+    Counted::moves = 0;
+
+    ASSERT_TRUE(set.patch(2, [](Counted& c){ c.values.push_back(2); }));
+    ASSERT_FALSE(set.patch(3, [](Counted&){ FAIL(); }));
+
+    ASSERT_EQ(set.get(2).values, (std::vector<int>{1, 2}));
+    ASSERT_EQ(Counted::copies + Counted::moves, 0);
+}
+
+struct Pinned
+{
+    int value;
+    std::string name;
+};
+
+template <>
+struct entis::storage_traits<Pinned>
+{
+    static constexpr bool in_place_delete = true;
+    static constexpr size_t page_size = 4;
+};
+
+TEST(SparseSetTest, PagedValuesKeepTheirAddress)
+{
+    entis::SparseSet<Pinned> set{};
+
+    set.bind(0, 0, std::string{"zero"});
+
+    const Pinned* first = &set.get(0);
+
+    // grow through several pages.
+    for(entis::id_t i = 1; i < 32; ++i)
+        set.bind(i, static_cast<int>(i), std::string{"value"});
+
+    ASSERT_EQ(&set.get(0), first);
+    ASSERT_EQ(set.size(), 32);
+
+    const Pinned* last = &set.get(31);
+
+    // unbinding doesn't move the rest of the values.
+    ASSERT_EQ(set.unbind(5).value().value, 5);
+    set.delete_component(7);
+
+    ASSERT_EQ(&set.get(31), last);
+    ASSERT_EQ(set.size(), 30);
+    ASSERT_EQ(set.keys().size(), 32);
+    ASSERT_EQ(set.keys()[5], entis::MAX_ID);
+    ASSERT_FALSE(set.has_data(5));
+    ASSERT_FALSE(set.has_data(entis::MAX_ID));
+
+    // holes are reused.
+    set.bind(40, 40, std::string{"forty"});
+
+    ASSERT_EQ(set.keys().size(), 32);
+    ASSERT_EQ(set.index(40), 7);
+    ASSERT_EQ(set.get(40).name, std::string{"forty"});
+}
+
+TEST(SparseSetTest, CanCompactPagedValues)
+{
+    entis::SparseSet<Pinned> set{};
+
+    for(entis::id_t i = 0; i < 10; ++i)
+        set.bind(i, static_cast<int>(i), std::string{"value"});
+
+    for(entis::id_t i = 0; i < 10; i += 3)
+        set.unbind(i);
+
+    set.compact();
+
+    ASSERT_EQ(set.size(), 6);
+    ASSERT_EQ(set.keys(), (std::pmr::vector<entis::id_t>{1, 2, 4, 5, 7, 8}));
+
+    for(const entis::id_t key : set.keys())
+    {
+        ASSERT_EQ(set.get(key).value, static_cast<int>(key));
+        ASSERT_EQ(set.keys()[set.index(key)], key);
+    }
+
+    set.bind(20, 20, std::string{"twenty"});
+
+    ASSERT_EQ(set.index(20), 6);
+}
+
+TEST(SparseSetTest, CanSortValues)
+{
+    entis::SparseSet<int> set{};
+
+    const std::vector<int> values{5, 3, 9, 1, 7};
+
+    for(entis::id_t i = 0; i < values.size(); ++i)
+        set.bind(i, values[i]);
+
+    set.sort([](const int a, const int b) { return a < b; });
+
+    ASSERT_EQ(std::vector<int>(set.begin(), set.end()), (std::vector<int>{1, 3, 5, 7, 9}));
+    ASSERT_EQ(set.keys(), (std::pmr::vector<entis::id_t>{3, 1, 0, 4, 2}));
+
+    for(entis::id_t i = 0; i < values.size(); ++i)
+    {
+        ASSERT_EQ(set.get(i), values[i]);
+        ASSERT_EQ(set.keys()[set.index(i)], i);
+    }
+
+    // a nearly sorted set, re-sorted with insertion sort.
+    set.patch(4, [](int& value) { value = 2; });
+
+    set.sort([](const int a, const int b) { return a < b; }, entis::InsertionSort{});
+
+    ASSERT_EQ(std::vector<int>(set.begin(), set.end()), (std::vector<int>{1, 2, 3, 5, 9}));
+    ASSERT_EQ(set.keys(), (std::pmr::vector<entis::id_t>{3, 4, 1, 0, 2}));
+
+    // sorted by key.
+    entis::SparseSet<std::string> names{};
+
+    names.bind(2, std::string{"two"});
+    names.bind(7, std::string{"seven"});
+    names.bind(4, std::string{"four"});
+
+    names.sort([](const entis::id_t a, const entis::id_t b) { return a > b; });
+
+    ASSERT_EQ(names.keys(), (std::pmr::vector<entis::id_t>{7, 4, 2}));
+    ASSERT_EQ(names.get(4), std::string{"four"});
+}
+
+TEST(SparseSetTest, CanSortAsAnotherSet)
+{
+    entis::SparseSet<int> set{};
+    entis::SparseSet<std::string> other{};
+
+    for(entis::id_t i = 0; i < 6; ++i)
+        set.bind(i, static_cast<int>(i));
+
+    other.bind(4, std::string{"four"});
+    other.bind(9, std::string{"nine"});
+    other.bind(1, std::string{"one"});
+    other.bind(3, std::string{"three"});
+
+    ASSERT_EQ(set.sort_as(other), 3);
+    ASSERT_EQ(set.keys()[0], 4);
+    ASSERT_EQ(set.keys()[1], 1);
+    ASSERT_EQ(set.keys()[2], 3);
+
+    for(entis::id_t i = 0; i < 6; ++i)
+    {
+        ASSERT_EQ(set.get(i), static_cast<int>(i));
+        ASSERT_EQ(set.keys()[set.index(i)], i);
+    }
+}
+
+TEST(SparseSetTest, AllocatesFromMemoryResource)
+{
+    std::array<std::byte, 1 << 16> buffer{};
+    std::pmr::monotonic_buffer_resource arena{buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+
+    {
+        entis::SparseSet<std::pmr::string> set{&arena};
+
+        ASSERT_EQ(set.resource(), &arena);
+
+        set.bind(0, "a string long enough to skip the small string buffer");
+        set.bind(5000, "another string long enough to skip the small string buffer");
+
+        // allocator-aware values get the resource too.
+        ASSERT_EQ(set.get(0).get_allocator().resource(), &arena);
+        ASSERT_EQ(set.get(5000), std::pmr::string{"another string long enough to skip the small string buffer"});
+
+        entis::SparseSet<Pinned> pinned{&arena};
+
+        for(entis::id_t i = 0; i < 8; ++i)
+            pinned.bind(i, static_cast<int>(i), std::string{"value"});
+
+        ASSERT_EQ(pinned.get(7).value, 7);
+    }
+}
+
+TEST(SparseSetTest, CanFindManyKeys)
+{
+    entis::SparseSet<int> set{};
+
+    std::vector<entis::id_t> keys{};
+
+    // more keys than a batch, spread over several pages.
+    for(entis::id_t key = 0; key < 100; ++key)
+    {
+        set.bind(key * 1000, static_cast<int>(key));
+        keys.push_back(key * 1000);
+    }
+
+    keys.push_back(7);                 // never bound.
+    keys.push_back(entis::MAX_ID);     // the null key.
+    keys.push_back(200 * 1000);        // out of the sparse array.
+
+    set.unbind(5000);
+
+    std::vector<int*> values(keys.size());
+
+    ASSERT_EQ(set.get_many(keys.begin(), keys.end(), values.begin()), values.end());
+
+    for(size_t i = 0; i < 100; ++i)
+    {
+        if(i == 5)
+        {
+            ASSERT_EQ(values[i], nullptr);
+            continue;
+        }
+
+        ASSERT_EQ(values[i], set.find(keys[i]));
+        ASSERT_EQ(*values[i], static_cast<int>(i));
+    }
+
+    ASSERT_EQ(values[100], nullptr);
+    ASSERT_EQ(values[101], nullptr);
+    ASSERT_EQ(values[102], nullptr);
+    ASSERT_EQ(set.find(7), nullptr);
+    ASSERT_EQ(set.index(5000), entis::MAX_ID);
+    ASSERT_EQ(set.index(1000), 1u);
+}
@@ -0,0 +1,140 @@
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+#include <entis/stats.h>
+#include <entis/registry.h>
+#include <entis/type_index.h>
+
+// Utily structs used for testing purposes.
+
+struct Ballast
+{
+    double mass;
+};
+
+struct Anchored
+{
+};
+
+TEST(StatsTest, ReportsPoolMemory)
+{
+    entis::Registry registry{};
+
+    ASSERT_TRUE(registry.pool_stats().empty());
+
+    std::vector<entis::id_t> entities(100);
+
+    registry.create(entities.size(), entities.begin());
+
+    for(const entis::id_t entity : entities)
+        registry.bind<Ballast>(entity, 1.0);
+
+    registry.bind<Anchored>(entities[0]);
+    registry.reserve<Ballast>(1000);
+
+    const std::vector<entis::PoolStats> stats = registry.pool_stats();
+
+    ASSERT_EQ(stats.size(), 2);
+
+    const auto ballast = std::find_if(stats.begin(), stats.end(), [](const entis::PoolStats& pool)
+    {
+        return pool.type == entis::TypeIndex::get<Ballast>();
+    });
+
+    ASSERT_NE(ballast, stats.end());
+    ASSERT_EQ(ballast->size, 100);
+    ASSERT_GE(ballast->capacity, 1000);
+    ASSERT_EQ(ballast->sparse_pages, 1);
+    ASSERT_GE(ballast->bytes, 1000 * (sizeof(Ballast) + sizeof(entis::id_t)) + entis::SPARSE_PAGE_SIZE * sizeof(entis::id_t));
+
+    const auto anchored = std::find_if(stats.begin(), stats.end(), [](const entis::PoolStats& pool)
+    {
+        return pool.type == entis::TypeIndex::get<Anchored>();
+    });
+
+    // tags only hold keys.
+    ASSERT_NE(anchored, stats.end());
+    ASSERT_EQ(anchored->size, 1);
+    ASSERT_LT(anchored->bytes, ballast->bytes);
+}
+
+#ifdef ENTIS_ENABLE_STATS
+
+static std::vector<const char*> profiled{};
+
+static void record_scope(const char* name, const uint64_t begin, const uint64_t end)
+{
+    ASSERT_LE(begin, end);
+
+    profiled.push_back(name);
+}
+
+TEST(StatsTest, CountsStructuralChanges)
+{
+    entis::Registry registry{};
+
+    std::vector<entis::id_t> entities(10);
+
+    registry.create(entities.size(), entities.begin());
+
+    for(const entis::id_t entity : entities)
+        registry.bind<Ballast>(entity, 1.0);
+
+    registry.bind<Anchored>(entities[0]);
+    registry.unbind<Ballast>(entities[1]);
+    registry.kill_entity(entities[0]);
+
+    ASSERT_EQ(registry.stats().created, 10);
+    ASSERT_EQ(registry.stats().bound, 11);
+    ASSERT_EQ(registry.stats().unbound, 3);
+    ASSERT_EQ(registry.stats().killed, 1);
+
+    registry.reset_stats();
+
+    ASSERT_EQ(registry.stats().bound, 0);
+}
+
+TEST(StatsTest, CountsQueriesPerSignature)
+{
+    entis::Registry registry{};
+
+    std::vector<entis::id_t> entities(10);
+
+    registry.create(entities.size(), entities.begin());
+
+    for(size_t i = 0; i < entities.size(); ++i)
+    {
+        registry.bind<Ballast>(entities[i], 1.0);
+
+        if(i % 2 == 0)
+            registry.bind<Anchored>(entities[i]);
+    }
+
+    entis::profile_hook() = record_scope;
+
+    const auto view = registry.view<Ballast>(entis::exclude<Anchored>);
+
+    entis::QueryStats& stats = entis::detail::query_stats_of<std::remove_const_t<decltype(view)>>();
+
+    stats.reset();
+
+    view.each([](Ballast&){});
+    view.each([](Ballast&){});
+
+    entis::profile_hook() = nullptr;
+
+    ASSERT_EQ(stats.calls, 2);
+    ASSERT_EQ(stats.scanned, 20);
+    ASSERT_EQ(stats.matched, 10);
+    ASSERT_EQ(profiled.size(), 2);
+    ASSERT_EQ(profiled[0], stats.name);
+
+    const std::vector<entis::QueryStats*> all = entis::query_stats();
+
+    ASSERT_NE(std::find(all.begin(), all.end(), &stats), all.end());
+}
+
+#endif
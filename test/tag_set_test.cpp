@@ -0,0 +1,124 @@
+#include <tuple>
+#include <vector>
+#include <type_traits>
+
+#include <gtest/gtest.h>
+
+#include <entis/tag_set.h>
+#include <entis/registry.h>
+
+// Utily structs used for testing purposes.
+
+struct Dead
+{
+};
+
+struct Selected
+{
+};
+
+struct Sealed
+{
+    explicit Sealed(int)
+    {
+
+    }
+};
+
+struct Speed
+{
+    Speed(const float value)
+    : value{value}
+    {
+
+    }
+
+    float value;
+};
+
+TEST(TagSetTest, StoresTagsAsMembershipOnly)
+{
+    ASSERT_TRUE(entis::is_tag_v<Dead>);
+    ASSERT_FALSE(entis::is_tag_v<Speed>);
+    ASSERT_TRUE((std::is_same_v<entis::ComponentManager<Dead>, entis::TagSet<Dead>*>));
+
+    entis::TagSet<Dead> set{};
+
+    set.bind(3);
+    set.bind(7, Dead{});
+    set.bind(3);
+
+    ASSERT_EQ(set.size(), 2);
+    ASSERT_TRUE(set.has_data(3));
+    ASSERT_TRUE(set.get_data(7).has_value());
+    ASSERT_FALSE(set.get_data(4).has_value());
+
+    ASSERT_TRUE(set.unbind(3).has_value());
+    ASSERT_FALSE(set.unbind(3).has_value());
+
+    ASSERT_EQ(set.keys(), (std::pmr::vector<entis::id_t>{7}));
+}
+
+TEST(TagSetTest, QueriesAndViewsUseTagsAsFilters)
+{
+    entis::Registry registry{};
+
+    std::vector<entis::id_t> entities(6);
+
+    registry.create(entities.size(), entities.begin());
+
+    for(const entis::id_t entity : entities)
+        registry.bind<Speed>(entity, static_cast<float>(entis::to_index(entity)));
+
+    registry.bind<Selected>(entities[1]);
+    registry.bind<Selected>(entities[2]);
+    registry.bind<Selected>(entities[4]);
+    registry.bind<Dead>(entities[2]);
+
+    using With = entis::typing::type_list_t<Speed, Selected>;
+    using Without = entis::typing::type_list_t<Dead>;
+
+    const entis::QueryResult<With> result = registry.query<With, Without>();
+
+    // the tuples only hold the components with data.
+    ASSERT_TRUE((std::is_same_v<entis::QueryResult<With>::value_type, std::tuple<std::reference_wrapper<const Speed>>>));
+    ASSERT_EQ(result.size(), 2);
+
+    auto view = registry.view<Speed, Selected>(entis::exclude<Dead>);
+
+    ASSERT_TRUE((std::is_same_v<decltype(view)::Entry, std::tuple<entis::id_t, Speed&>>));
+
+    float total = 0.0f;
+
+    for(auto [entity, speed] : view)
+        total += speed.value;
+
+    view.each([&total](Speed& speed){ total += speed.value; });
+
+    ASSERT_EQ(total, 2 * (1.0f + 4.0f));
+
+    size_t selected = 0;
+
+    registry.view<Selected>().each([&selected](const entis::id_t){ ++selected; });
+
+    ASSERT_EQ(selected, 3);
+
+    registry.kill_entity(entities[1]);
+
+    ASSERT_FALSE(registry.has_component<Selected>(entities[1]));
+    ASSERT_EQ(registry.entities_with_component<Selected>().size(), 2);
+}
+
+TEST(TagSetTest, EmptyTypesWithoutDefaultConstructorAreNotTags)
+{
+    static_assert(!entis::is_tag_v<Sealed>);
+    static_assert(std::is_same_v<entis::ComponentManager<Sealed>, entis::SparseSet<Sealed>*>);
+
+    entis::Registry registry{};
+
+    const entis::id_t entity = registry.make_entity();
+
+    ASSERT_FALSE(registry.bind<Sealed>(entity, 1).has_value());
+    ASSERT_TRUE(registry.has_component<Sealed>(entity));
+    ASSERT_EQ(registry.view<Sealed>().size_hint(), 1);
+}
@@ -0,0 +1,43 @@
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <entis/type_index.h>
+
+TEST(TypeIndexTest, SameTypeSameIndex)
+{
+    const entis::id_t first = entis::TypeIndex::get<std::string>();
+    const entis::id_t second = entis::TypeIndex::get<std::string>();
+
+    ASSERT_EQ(first, second);
+    ASSERT_EQ(entis::TypeIndex::get<const std::string&>(), first);
+}
+
+TEST(TypeIndexTest, DifferentTypesDifferentIndex)
+{
+    const entis::id_t a = entis::TypeIndex::get<int>();
+    const entis::id_t b = entis::TypeIndex::get<double>();
+    const entis::id_t c = entis::TypeIndex::get<char>();
+
+    ASSERT_NE(a, b);
+    ASSERT_NE(b, c);
+    ASSERT_NE(a, c);
+}
+
+TEST(TypeIndexTest, FamiliesHaveTheirOwnCounter)
+{
+    struct Family;
+    struct Unused;
+
+    // a family only used here starts from zero.
+    ASSERT_EQ(entis::BasicTypeIndex<Family>::get<int>(), 0u);
+    ASSERT_EQ(entis::BasicTypeIndex<Family>::get<double>(), 1u);
+    ASSERT_EQ(entis::BasicTypeIndex<Family>::get<int>(), 0u);
+
+    // and doesn't use up component identifiers.
+    const entis::id_t before = entis::TypeIndex::get<Family>();
+
+    entis::BasicTypeIndex<Family>::get<char>();
+
+    ASSERT_EQ(entis::TypeIndex::get<Unused>(), before + 1);
+}
@@ -126,3 +126,43 @@ TEST(TypeListTest, CanTransformList)
 
     ASSERT_TRUE((entis::typing::is_equal<result, expected>()));
 }
+
+TEST(TypeListTest, CanFilterList)
+{
+    using test = entis::typing::type_list_t<double, uint32_t, float, char>;
+
+    using expected = entis::typing::type_list_t<uint32_t, char>;
+
+    using result = entis::typing::filter<test, std::is_integral>;
+    using empty = entis::typing::filter<entis::typing::type_list_t<>, std::is_integral>;
+
+    ASSERT_TRUE((entis::typing::is_equal<result, expected>()));
+    ASSERT_TRUE((entis::typing::is_equal<empty, entis::typing::type_list_t<>>()));
+}
+
+TEST(TypeListTest, CanCheckMembership)
+{
+    using test = entis::typing::type_list_t<double, uint32_t, float>;
+
+    ASSERT_TRUE((entis::typing::contains<test, float>));
+    ASSERT_FALSE((entis::typing::contains<test, char>));
+    ASSERT_FALSE((entis::typing::contains<entis::typing::type_list_t<>, char>));
+
+    ASSERT_TRUE((entis::typing::is_disjoint<test, entis::typing::type_list_t<char, int>>));
+    ASSERT_FALSE((entis::typing::is_disjoint<test, entis::typing::type_list_t<char, double>>));
+    ASSERT_TRUE((entis::typing::is_disjoint<entis::typing::type_list_t<>, test>));
+}
+
+TEST(TypeListTest, CanRemoveRepeatedTypes)
+{
+    using test = entis::typing::type_list_t<double, uint32_t, double, float, uint32_t>;
+
+    using expected = entis::typing::type_list_t<double, uint32_t, float>;
+
+    using result = entis::typing::unique<test>;
+
+    ASSERT_TRUE((entis::typing::is_equal<result, expected>()));
+    ASSERT_TRUE((entis::typing::is_unique<expected>));
+    ASSERT_FALSE((entis::typing::is_unique<test>));
+    ASSERT_TRUE((entis::typing::is_unique<entis::typing::type_list_t<>>));
+}
@@ -0,0 +1,216 @@
+#include <atomic>
+#include <vector>
+#include <type_traits>
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+#include <entis/view.h>
+#include <entis/thread_pool.h>
+#include <entis/registry.h>
+
+// Utily structs used for testing purposes.
+
+struct Position
+{
+    Position(const float x, const float y)
+    : x{x},
+      y{y}
+    {
+
+    }
+
+    float x;
+    float y;
+};
+
+struct Velocity
+{
+    Velocity(const float dx, const float dy)
+    : dx{dx},
+      dy{dy}
+    {
+
+    }
+
+    float dx;
+    float dy;
+};
+
+struct Animation
+{
+    Animation(const int frame)
+    : frame{frame}
+    {
+
+    }
+
+    int frame;
+};
+
+template <>
+struct entis::storage_traits<Animation>
+{
+    static constexpr bool in_place_delete = true;
+    static constexpr size_t page_size = 8;
+};
+
+TEST(ViewTest, CanIterateWithRangeFor)
+{
+    entis::Registry registry{};
+
+    const entis::id_t e0 = registry.make_entity();
+    const entis::id_t e1 = registry.make_entity();
+    const entis::id_t e2 = registry.make_entity();
+
+    registry.bind<Position>(e0, 0.0f, 0.0f);
+    registry.bind<Position>(e1, 1.0f, 1.0f);
+    registry.bind<Position>(e2, 2.0f, 2.0f);
+
+    registry.bind<Velocity>(e0, 1.0f, 2.0f);
+    registry.bind<Velocity>(e2, 1.0f, 2.0f);
+
+    std::vector<entis::id_t> visited{};
+
+    for(auto [entity, position, velocity] : registry.view<Position, Velocity>())
+    {
+        position.x += velocity.dx;
+        position.y += velocity.dy;
+
+        visited.push_back(entity);
+    }
+
+    ASSERT_EQ(visited, (std::vector<entis::id_t>{e0, e2}));
+
+    ASSERT_EQ(registry.get_component<Position>(e0).value().get().x, 1.0f);
+    ASSERT_EQ(registry.get_component<Position>(e1).value().get().x, 1.0f);
+    ASSERT_EQ(registry.get_component<Position>(e2).value().get().y, 4.0f);
+}
+
+TEST(ViewTest, CanExcludeComponents)
+{
+    entis::Registry registry{};
+
+    const entis::id_t e0 = registry.make_entity();
+    const entis::id_t e1 = registry.make_entity();
+
+    registry.bind<Position>(e0, 0.0f, 0.0f);
+    registry.bind<Position>(e1, 1.0f, 1.0f);
+
+    registry.bind<char>(e0, 'a');
+
+    std::vector<entis::id_t> visited{};
+
+    registry.view<Position>(entis::exclude<char>).each([&visited](const entis::id_t entity, Position&)
+    {
+        visited.push_back(entity);
+    });
+
+    ASSERT_EQ(visited, (std::vector<entis::id_t>{e1}));
+
+    // excluding a component without manager doesn't filter anything.
+    ASSERT_EQ(std::distance(registry.view<Position>(entis::exclude<double>).begin(),
+                            registry.view<Position>(entis::exclude<double>).end()), 2);
+
+    // repeated exclusions are merged.
+    using Merged = decltype(registry.view<Position>(entis::exclude<char, double, char>));
+
+    static_assert(std::is_same_v<Merged,
+        entis::View<entis::typing::type_list_t<Position>, entis::typing::type_list_t<char, double>>>);
+
+    ASSERT_EQ(registry.view<Position>(entis::exclude<char, char>).begin(), 
+              registry.view<Position>(entis::exclude<char>).begin());
+}
+
+TEST(ViewTest, CanIterateWithoutEntity)
+{
+    entis::Registry registry{};
+
+    const entis::id_t e0 = registry.make_entity();
+
+    registry.bind<Position>(e0, 1.0f, 1.0f);
+    registry.bind<Velocity>(e0, 1.0f, 1.0f);
+
+    registry.view<Position, Velocity>().each([](Position& position, const Velocity& velocity)
+    {
+        position.x *= velocity.dx + 1.0f;
+    });
+
+    ASSERT_EQ(registry.get_component<Position>(e0).value().get().x, 2.0f);
+}
+
+TEST(ViewTest, EmptyWhenManagerDoesNotExist)
+{
+    entis::Registry registry{};
+
+    const entis::id_t e0 = registry.make_entity();
+
+    registry.bind<Position>(e0, 1.0f, 1.0f);
+
+    auto view = registry.view<Position, Velocity>();
+
+    ASSERT_EQ(view.size_hint(), 0);
+    ASSERT_TRUE(view.begin() == view.end());
+    ASSERT_FALSE(view.contains(e0));
+}
+
+TEST(ViewTest, CanIterateInParallel)
+{
+    entis::Registry registry{};
+    entis::ThreadPool pool{4};
+
+    for(int i = 0; i < 1000; ++i)
+    {
+        const entis::id_t entity = registry.make_entity();
+
+        registry.bind<Position>(entity, static_cast<float>(i), 0.0f);
+
+        if(i % 3 != 0)
+            registry.bind<Velocity>(entity, 1.0f, 2.0f);
+    }
+
+    std::atomic<size_t> visited{0};
+
+    registry.view<Position, Velocity>().each_par(pool, [&visited](Position& position, const Velocity& velocity)
+    {
+        position.y += velocity.dy;
+        visited.fetch_add(1);
+    }, 16);
+
+    ASSERT_EQ(visited.load(), 666);
+
+    registry.view<Position>().each([](const entis::id_t entity, const Position& position)
+    {
+        ASSERT_EQ(position.y, (entity % 3 != 0) ? 2.0f : 0.0f);
+    });
+}
+
+TEST(ViewTest, SkipsHolesOfPagedManagers)
+{
+    entis::Registry registry{};
+
+    std::vector<entis::id_t> entities(6);
+
+    registry.create(entities.size(), entities.begin());
+
+    for(const entis::id_t entity : entities)
+        registry.bind<Animation>(entity, static_cast<int>(entis::to_index(entity)));
+
+    registry.unbind<Animation>(entities[1]);
+    registry.kill_entity(entities[4]);
+
+    int visited = 0;
+
+    for(auto [entity, animation] : registry.view<Animation>())
+    {
+        ASSERT_NE(entity, entities[1]);
+        ASSERT_NE(entity, entities[4]);
+        ASSERT_EQ(animation.frame, static_cast<int>(entis::to_index(entity)));
+
+        ++visited;
+    }
+
+    ASSERT_EQ(visited, 4);
+    ASSERT_EQ(registry.entities_with_component<Animation>().size(), 4);
+    ASSERT_EQ(registry.query<entis::typing::type_list_t<Animation>>().size(), 4);
+}